@@ -0,0 +1,185 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/* Tiled Cholesky factorization as in `examples/cholesky.cpp`
+ * of a symmetric positive definite matrix with `tiles` x `tiles` tiles of `tile` x `tile` elements.
+ * With `REDGRAPES_BENCH_LAPACK`, the tile kernels are taken from BLAS and LAPACK,
+ * otherwise simple reference kernels are used, so the GFLOP/s are only comparable
+ * between runs built the same way.
+ *
+ * parameters: tiles=8 tile=64
+ */
+
+#include "driver.hpp"
+
+#include <redGrapes/resource/ioresource.hpp>
+
+#include <cmath>
+#include <vector>
+
+#if REDGRAPES_BENCH_LAPACK
+#    include <cblas.h>
+#    include <lapacke.h>
+#endif
+
+using Tile = std::vector<double>;
+
+namespace
+{
+    // all tiles are stored column-major
+
+    //! C = C - A * B^T
+    void gemm(Tile const& a, Tile const& b, Tile& c, int n)
+    {
+#if REDGRAPES_BENCH_LAPACK
+        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasTrans, n, n, n, -1.0, a.data(), n, b.data(), n, 1.0, c.data(), n);
+#else
+        for(int col = 0; col < n; ++col)
+            for(int k = 0; k < n; ++k)
+            {
+                double const bk = b[col + k * n];
+                for(int row = 0; row < n; ++row)
+                    c[row + col * n] -= a[row + k * n] * bk;
+            }
+#endif
+    }
+
+    //! lower part of C = C - A * A^T
+    void syrk(Tile const& a, Tile& c, int n)
+    {
+#if REDGRAPES_BENCH_LAPACK
+        cblas_dsyrk(CblasColMajor, CblasLower, CblasNoTrans, n, n, -1.0, a.data(), n, 1.0, c.data(), n);
+#else
+        for(int col = 0; col < n; ++col)
+            for(int k = 0; k < n; ++k)
+            {
+                double const ak = a[col + k * n];
+                for(int row = col; row < n; ++row)
+                    c[row + col * n] -= a[row + k * n] * ak;
+            }
+#endif
+    }
+
+    //! A = L * L^T, L is stored in the lower part of A
+    void potrf(Tile& a, int n)
+    {
+#if REDGRAPES_BENCH_LAPACK
+        LAPACKE_dpotrf(LAPACK_COL_MAJOR, 'L', n, a.data(), n);
+#else
+        for(int col = 0; col < n; ++col)
+        {
+            for(int k = 0; k < col; ++k)
+                a[col + col * n] -= a[col + k * n] * a[col + k * n];
+            a[col + col * n] = std::sqrt(a[col + col * n]);
+
+            for(int row = col + 1; row < n; ++row)
+            {
+                for(int k = 0; k < col; ++k)
+                    a[row + col * n] -= a[row + k * n] * a[col + k * n];
+                a[row + col * n] /= a[col + col * n];
+            }
+        }
+#endif
+    }
+
+    //! B = B * L^-T
+    void trsm(Tile const& l, Tile& b, int n)
+    {
+#if REDGRAPES_BENCH_LAPACK
+        cblas_dtrsm(
+            CblasColMajor,
+            CblasRight,
+            CblasLower,
+            CblasTrans,
+            CblasNonUnit,
+            n,
+            n,
+            1.0,
+            l.data(),
+            n,
+            b.data(),
+            n);
+#else
+        for(int col = 0; col < n; ++col)
+        {
+            for(int k = 0; k < col; ++k)
+            {
+                double const lk = l[col + k * n];
+                for(int row = 0; row < n; ++row)
+                    b[row + col * n] -= b[row + k * n] * lk;
+            }
+            for(int row = 0; row < n; ++row)
+                b[row + col * n] /= l[col + col * n];
+        }
+#endif
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    auto opt = bench::app::parse(argc, argv);
+    size_t const nblks = opt.get<size_t>("tiles", 8);
+    int const blksz = opt.get<int>("tile", 64);
+
+    return bench::app::run(
+        "cholesky",
+        opt,
+        [&](auto& rg)
+        {
+            std::vector<redGrapes::IOResource<Tile>> A;
+            for(size_t t = 0; t < nblks * nblks; ++t)
+                A.emplace_back(blksz * blksz);
+
+            return [&rg, A, nblks, blksz](bench::app::Timer& timer)
+            {
+                size_t const N = nblks * blksz;
+
+                // symmetric, diagonally dominant and hence positive definite
+                for(size_t ja = 0; ja < nblks; ++ja)
+                    for(size_t ia = 0; ia < nblks; ++ia)
+                        for(int jb = 0; jb < blksz; ++jb)
+                            for(int ib = 0; ib < blksz; ++ib)
+                            {
+                                size_t const i = ia * blksz + ib, j = ja * blksz + jb;
+                                size_t const lo = std::min(i, j), hi = std::max(i, j);
+                                (*A[ja * nblks + ia])[jb * blksz + ib]
+                                    = double((lo * 31 + hi * 17) % 100) / 100.0 + (i == j ? double(N) : 0.0);
+                            }
+
+                timer.start();
+
+                for(size_t j = 0; j < nblks; j++)
+                {
+                    for(size_t k = 0; k < j; k++)
+                        for(size_t i = j + 1; i < nblks; i++)
+                            rg.emplace_task(
+                                [blksz](auto a, auto b, auto c) { bench::app::work([&] { gemm(*a, *b, *c, blksz); }); },
+                                A[k * nblks + i].read(),
+                                A[k * nblks + j].read(),
+                                A[j * nblks + i].write());
+
+                    for(size_t i = 0; i < j; i++)
+                        rg.emplace_task(
+                            [blksz](auto a, auto c) { bench::app::work([&] { syrk(*a, *c, blksz); }); },
+                            A[i * nblks + j].read(),
+                            A[j * nblks + j].write());
+
+                    rg.emplace_task(
+                        [blksz](auto a) { bench::app::work([&] { potrf(*a, blksz); }); },
+                        A[j * nblks + j].write());
+
+                    for(size_t i = j + 1; i < nblks; i++)
+                        rg.emplace_task(
+                            [blksz](auto a, auto b) { bench::app::work([&] { trsm(*a, *b, blksz); }); },
+                            A[j * nblks + j].read(),
+                            A[j * nblks + i].write());
+                }
+
+                return double(N) * N * N / 3.0;
+            };
+        });
+}
@@ -0,0 +1,380 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/* Common driver for the application benchmarks.
+ *
+ * Each application is run for every requested number of workers,
+ * a few times for warm-up and then `repeat` times for measurement.
+ * Task bodies are wrapped in `work()`, which sums up the time spent
+ * inside of tasks, so that the time spent in the runtime can be derived:
+ *
+ *   utilization = busy / (workers * wall)
+ *   overhead    = (workers * wall - busy) / tasks
+ *
+ * where the overhead per task includes idle time of the workers.
+ * If the first worker count is 1, speedup and parallel efficiency
+ * are computed relative to it. Applications which know a lower bound of the
+ * makespan set `Options::ideal_s`, and the ratio of the wall time to it is reported.
+ *
+ * Workers are bound to processing units according to `--placement`
+ * (see `redGrapes::Placement`), and each run reports the PUs and the number of
+ * packages it used, together with the scheduler counters summed over all measured runs.
+ *
+ * Command line: `--workers=1,2,4 --repeat=5 --warmup=1 --placement=compact --json=out.json key=value ...`,
+ * where the key-value pairs are application parameters.
+ * The results are printed as JSON to stdout and to the file given by `--json`,
+ * and can be compared with `benchmarks/compare.py` or collected by `benchmarks/sweep.py`.
+ */
+
+#pragma once
+
+#include <redGrapes/redGrapes.hpp>
+#include <redGrapes/util/tsc_clock.hpp>
+
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bench
+{
+    namespace app
+    {
+
+        struct Options
+        {
+            std::vector<unsigned> workers;
+            unsigned repeat = 5;
+            unsigned warmup = 1;
+            redGrapes::Placement placement = redGrapes::placement_from_env();
+            std::string json;
+
+            //! application parameters, including the defaults which were used
+            std::map<std::string, std::string> params;
+
+            //! optional lower bound of the wall time in seconds for a given number of workers
+            std::function<double(unsigned)> ideal_s;
+
+            //! get an application parameter and record its value for the output
+            template<typename T>
+            T get(std::string const& key, T fallback)
+            {
+                auto it = params.find(key);
+                if(it == params.end())
+                {
+                    params[key] = fmt::format("{}", fallback);
+                    return fallback;
+                }
+
+                T value;
+                std::istringstream(it->second) >> value;
+                return value;
+            }
+        };
+
+        inline std::vector<unsigned> parse_list(std::string const& s)
+        {
+            std::vector<unsigned> list;
+            std::istringstream in(s);
+            for(std::string item; std::getline(in, item, ',');)
+                if(!item.empty())
+                    list.push_back(std::max(1, std::atoi(item.c_str())));
+            return list;
+        }
+
+        inline Options parse(int argc, char* argv[])
+        {
+            Options opt;
+            for(int i = 1; i < argc; ++i)
+            {
+                std::string const arg = argv[i];
+                auto const eq = arg.find('=');
+                if(eq == std::string::npos)
+                {
+                    fmt::print(
+                        stderr,
+                        "usage: {} [--workers=1,2,4] [--repeat=5] [--warmup=1] [--placement=compact|scatter] "
+                        "[--json=file] [key=value ...]\n",
+                        argv[0]);
+                    std::exit(arg == "--help" ? 0 : 1);
+                }
+
+                std::string const key = arg.substr(0, eq);
+                std::string const value = arg.substr(eq + 1);
+                if(key == "--workers")
+                    opt.workers = parse_list(value);
+                else if(key == "--repeat")
+                    opt.repeat = std::max(1, std::atoi(value.c_str()));
+                else if(key == "--warmup")
+                    opt.warmup = std::atoi(value.c_str());
+                else if(key == "--placement")
+                {
+                    auto placement = redGrapes::parse_placement(value);
+                    if(!placement)
+                    {
+                        fmt::print(stderr, "unknown placement '{}', expected compact or scatter\n", value);
+                        std::exit(1);
+                    }
+                    opt.placement = *placement;
+                }
+                else if(key == "--json")
+                    opt.json = value;
+                else
+                    opt.params[key] = value;
+            }
+
+            if(opt.workers.empty())
+                for(unsigned n = 1; n <= std::max(1u, std::thread::hardware_concurrency()); n *= 2)
+                    opt.workers.push_back(n);
+
+            return opt;
+        }
+
+        //! time spent inside of task bodies
+        struct Work
+        {
+            static inline std::atomic<uint64_t> busy_ticks{0};
+            static inline std::atomic<uint64_t> tasks{0};
+
+            static void reset()
+            {
+                busy_ticks = 0;
+                tasks = 0;
+            }
+        };
+
+        //! execute the body of a task and account its duration
+        template<typename F>
+        inline void work(F&& f)
+        {
+            uint64_t const begin = redGrapes::TscClock::now();
+            f();
+            Work::busy_ticks.fetch_add(redGrapes::TscClock::now() - begin, std::memory_order_relaxed);
+            Work::tasks.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        //! measures the wall time of one run, started by the application after its setup
+        struct Timer
+        {
+            std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+            void start()
+            {
+                Work::reset();
+                begin = std::chrono::steady_clock::now();
+            }
+
+            double elapsed() const
+            {
+                return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            }
+        };
+
+        inline double median(std::vector<double> v)
+        {
+            std::sort(v.begin(), v.end());
+            size_t const n = v.size();
+            return n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2.0;
+        }
+
+        //! median absolute deviation, a noise estimate robust to outliers
+        inline double mad(std::vector<double> const& v)
+        {
+            double const m = median(v);
+            std::vector<double> dev;
+            for(double x : v)
+                dev.push_back(std::abs(x - m));
+            return median(dev);
+        }
+
+        //! results for one number of workers
+        struct Result
+        {
+            unsigned workers = 0;
+            std::vector<double> wall_s;
+            std::vector<double> busy_s;
+            uint64_t tasks = 0;
+            double flop = 0.0;
+
+            //! scheduler counters summed over all measured runs
+            redGrapes::scheduler::SchedulerStats stats;
+        };
+
+        //! OS indices of the PUs of the first `n_workers` workers and the number of distinct packages among them
+        inline std::pair<std::vector<unsigned>, unsigned> worker_topology(unsigned n_workers)
+        {
+            std::vector<unsigned> pus;
+            std::vector<hwloc_obj_t> packages;
+            for(unsigned i = 0; i < n_workers; ++i)
+            {
+                hwloc_obj_t pu = redGrapes::TaskFreeCtx::get_worker_pu(i);
+                pus.push_back(pu->os_index);
+
+                hwloc_obj_t package = hwloc_get_ancestor_obj_by_type(
+                    redGrapes::TaskFreeCtx::hwloc_ctx.topology,
+                    HWLOC_OBJ_PACKAGE,
+                    pu);
+                if(std::find(packages.begin(), packages.end(), package) == packages.end())
+                    packages.push_back(package);
+            }
+            return {pus, unsigned(packages.size())};
+        }
+
+        inline std::string to_json(std::string const& app, Options const& opt, std::vector<Result> const& results)
+        {
+            std::string params;
+            for(auto const& [key, value] : opt.params)
+                params += fmt::format("{}\"{}\": \"{}\"", params.empty() ? "" : ", ", key, value);
+
+            std::string out = fmt::format(
+                "{{\n  \"app\": \"{}\",\n  \"params\": {{{}}},\n  \"hardware_concurrency\": {},\n"
+                "  \"placement\": \"{}\",\n  \"runs\": [",
+                app,
+                params,
+                std::thread::hardware_concurrency(),
+                redGrapes::placement_name(opt.placement));
+
+            double const t_serial = (!results.empty() && results[0].workers == 1) ? median(results[0].wall_s) : 0.0;
+
+            for(size_t i = 0; i < results.size(); ++i)
+            {
+                Result const& r = results[i];
+                double const wall = median(r.wall_s);
+                double const busy = median(r.busy_s);
+                double const capacity = r.workers * wall;
+
+                out += fmt::format(
+                    "{}\n    {{\"workers\": {}, \"wall_s\": [{:.9f}], \"median_s\": {:.9f}, \"mad_s\": {:.9f}, "
+                    "\"tasks\": {}, \"tasks_per_s\": {:.1f}, \"busy_s\": {:.9f}, \"utilization\": {:.4f}, "
+                    "\"overhead_ns_per_task\": {:.1f}",
+                    i ? "," : "",
+                    r.workers,
+                    fmt::join(r.wall_s, ", "),
+                    wall,
+                    mad(r.wall_s),
+                    r.tasks,
+                    r.tasks / wall,
+                    busy,
+                    busy / capacity,
+                    r.tasks ? std::max(0.0, capacity - busy) / r.tasks * 1e9 : 0.0);
+
+                if(r.flop > 0.0)
+                    out += fmt::format(", \"gflops\": {:.3f}", r.flop / wall * 1e-9);
+                if(double const ideal = opt.ideal_s ? opt.ideal_s(r.workers) : 0.0; ideal > 0.0)
+                    out += fmt::format(", \"ideal_s\": {:.9f}, \"ideal_ratio\": {:.4f}", ideal, wall / ideal);
+                if(t_serial > 0.0)
+                    out += fmt::format(
+                        ", \"speedup\": {:.3f}, \"efficiency\": {:.4f}",
+                        t_serial / wall,
+                        t_serial / capacity);
+
+                auto const [pus, packages] = worker_topology(r.workers);
+                out += fmt::format(
+                    ",\n     \"pus\": [{}], \"packages\": {},\n     \"scheduler\": {}",
+                    fmt::join(pus, ", "),
+                    packages,
+                    r.stats);
+                out += "}";
+            }
+            out += "\n  ]\n}\n";
+            return out;
+        }
+
+        /* run an application for all worker counts of `opt`.
+         *
+         * @param setup called as `setup(rg)` after the runtime was created,
+         *        allocates the resources of the application and returns
+         *        a callable `run_once(timer)`, which has to initialize the input,
+         *        call `timer.start()` and submit all tasks.
+         *        It returns the number of floating point operations, or zero.
+         *        The driver waits for all tasks before it stops the timer.
+         * @return process exit code
+         */
+        template<typename F>
+        int run(std::string const& app, Options& opt, F&& setup)
+        {
+            // keep stdout clean for the JSON output
+            spdlog::set_default_logger(spdlog::stderr_color_st(app));
+            spdlog::set_level(spdlog::level::warn);
+
+            std::vector<Result> results;
+            for(unsigned n_workers : opt.workers)
+            {
+                Result r;
+                r.workers = n_workers;
+                redGrapes::TaskFreeCtx::placement = opt.placement;
+                auto rg = redGrapes::init(n_workers);
+
+                // resources have to be released before the runtime
+                {
+                    auto run_once = setup(rg);
+                    for(unsigned i = 0; i < opt.warmup + opt.repeat; ++i)
+                    {
+                        rg.reset_scheduler_stats();
+
+                        Timer timer;
+                        double const flop = run_once(timer);
+                        rg.barrier();
+                        double const wall = timer.elapsed();
+
+                        if(i < opt.warmup)
+                            continue;
+
+                        for(auto const& s : rg.scheduler_stats())
+                            r.stats += s;
+
+                        r.wall_s.push_back(wall);
+                        r.busy_s.push_back(redGrapes::TscClock::to_ns(Work::busy_ticks) * 1e-9);
+                        r.tasks = Work::tasks;
+                        r.flop = flop;
+                    }
+                }
+
+                fmt::print(
+                    stderr,
+                    "{}: {} workers ({}), median {:.3f} ms over {} runs\n",
+                    app,
+                    n_workers,
+                    redGrapes::placement_name(opt.placement),
+                    median(r.wall_s) * 1e3,
+                    r.wall_s.size());
+                results.push_back(std::move(r));
+            }
+
+            std::string const json = to_json(app, opt, results);
+            std::cout << json;
+
+            if(!opt.json.empty())
+            {
+                std::ofstream file(opt.json);
+                file << json;
+                if(!file)
+                {
+                    fmt::print(stderr, "could not write {}\n", opt.json);
+                    return 1;
+                }
+            }
+            return 0;
+        }
+
+    } // namespace app
+} // namespace bench
@@ -0,0 +1,125 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/* Game of life as in `examples/game_of_life.cpp`, on a periodic grid of
+ * `tiles` x `tiles` tiles with `tile` x `tile` cells each.
+ * Every generation, one task per tile reads the tile and its eight neighbours
+ * and writes the tile of the next buffer.
+ *
+ * parameters: tiles=8 tile=64 generations=50
+ */
+
+#include "driver.hpp"
+
+#include <redGrapes/resource/ioresource.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+enum Cell : uint8_t
+{
+    DEAD,
+    ALIVE
+};
+
+using Tile = std::vector<Cell>;
+
+int main(int argc, char* argv[])
+{
+    auto opt = bench::app::parse(argc, argv);
+    size_t const tiles = std::max<size_t>(3, opt.get<size_t>("tiles", 8));
+    size_t const b = opt.get<size_t>("tile", 64);
+    unsigned const generations = opt.get<unsigned>("generations", 50);
+
+    return bench::app::run(
+        "game_of_life",
+        opt,
+        [&](auto& rg)
+        {
+            std::vector<std::vector<redGrapes::IOResource<Tile>>> buffers(2);
+            for(auto& buf : buffers)
+                for(size_t t = 0; t < tiles * tiles; ++t)
+                    buf.emplace_back(b * b, DEAD);
+
+            return [&rg, buffers, tiles, b, generations](bench::app::Timer& timer)
+            {
+                std::default_random_engine generator;
+                std::bernoulli_distribution distribution{0.35};
+                for(auto& tile : buffers[0])
+                    for(Cell& c : *tile)
+                        c = distribution(generator) ? ALIVE : DEAD;
+
+                timer.start();
+
+                for(unsigned g = 0; g < generations; ++g)
+                {
+                    auto const& cur = buffers[g % 2];
+                    auto const& next = buffers[(g + 1) % 2];
+                    auto idx = [tiles](size_t x, size_t y) { return (y % tiles) * tiles + (x % tiles); };
+
+                    for(size_t ty = 0; ty < tiles; ++ty)
+                        for(size_t tx = 0; tx < tiles; ++tx)
+                        {
+                            size_t const l = tx + tiles - 1, r = tx + 1;
+                            size_t const u = ty + tiles - 1, d = ty + 1;
+
+                            rg.emplace_task(
+                                [b](auto dst, auto c, auto nw, auto n, auto ne, auto w, auto e, auto sw, auto s, auto se)
+                                {
+                                    bench::app::work(
+                                        [&]
+                                        {
+                                            long const lb = b;
+
+                                            // cell at (i, j) relative to the center tile
+                                            auto at = [&](long i, long j) -> int
+                                            {
+                                                int const row = i < 0 ? 0 : (i < lb ? 1 : 2);
+                                                int const col = j < 0 ? 0 : (j < lb ? 1 : 2);
+                                                i = (i + lb) % lb;
+                                                j = (j + lb) % lb;
+
+                                                Tile const* neighbours[3][3]
+                                                    = {{&*nw, &*n, &*ne}, {&*w, &*c, &*e}, {&*sw, &*s, &*se}};
+                                                return (*neighbours[row][col])[i * b + j];
+                                            };
+
+                                            for(long i = 0; i < lb; ++i)
+                                                for(long j = 0; j < lb; ++j)
+                                                {
+                                                    int const count = at(i - 1, j - 1) + at(i - 1, j)
+                                                                      + at(i - 1, j + 1) + at(i, j - 1) + at(i, j + 1)
+                                                                      + at(i + 1, j - 1) + at(i + 1, j)
+                                                                      + at(i + 1, j + 1);
+
+                                                    Cell next_state = (*c)[i * b + j];
+                                                    if(count < 2 || count > 3)
+                                                        next_state = DEAD;
+                                                    else if(count == 3)
+                                                        next_state = ALIVE;
+                                                    (*dst)[i * b + j] = next_state;
+                                                }
+                                        });
+                                },
+                                next[idx(tx, ty)].write(),
+                                cur[idx(tx, ty)].read(),
+                                cur[idx(l, u)].read(),
+                                cur[idx(tx, u)].read(),
+                                cur[idx(r, u)].read(),
+                                cur[idx(l, ty)].read(),
+                                cur[idx(r, ty)].read(),
+                                cur[idx(l, d)].read(),
+                                cur[idx(tx, d)].read(),
+                                cur[idx(r, d)].read());
+                        }
+                }
+
+                return 0.0;
+            };
+        });
+}
@@ -0,0 +1,133 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/* Random task graph like `test/random_graph.cpp`:
+ * each task reads or writes between `min_deps` and `max_deps` randomly chosen
+ * resources and busy-waits for `duration_us` microseconds.
+ * The length of the critical path (in tasks) is added to the parameters,
+ * so the achieved parallelism can be compared to the available one.
+ *
+ * parameters: tasks=2048 resources=64 min_deps=1 max_deps=4 read_ratio=0.5 duration_us=10 seed=42
+ */
+
+#include "driver.hpp"
+
+#include <redGrapes/resource/resource.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+namespace
+{
+    struct Access
+    {
+        unsigned resource;
+        bool write;
+    };
+
+    /* draw the accesses of all tasks
+     * @return accesses of each task and the length of the critical path
+     */
+    std::pair<std::vector<std::vector<Access>>, unsigned> generate(
+        unsigned n_tasks,
+        unsigned n_resources,
+        unsigned min_deps,
+        unsigned max_deps,
+        double read_ratio,
+        unsigned seed)
+    {
+        std::mt19937 gen(seed);
+        std::uniform_int_distribution<unsigned> distrib_n_deps(min_deps, max_deps);
+        std::uniform_int_distribution<unsigned> distrib_resource(0, n_resources - 1);
+        std::bernoulli_distribution distrib_read(read_ratio);
+
+        std::vector<std::vector<Access>> tasks(n_tasks);
+
+        // depth of the last writer and of the deepest reader since then, per resource
+        std::vector<unsigned> write_depth(n_resources), read_depth(n_resources);
+        unsigned critical_path = 0;
+
+        for(auto& accesses : tasks)
+        {
+            unsigned const n_deps = std::min(distrib_n_deps(gen), n_resources);
+            while(accesses.size() < n_deps)
+            {
+                unsigned const r = distrib_resource(gen);
+                if(std::none_of(accesses.begin(), accesses.end(), [r](Access const& a) { return a.resource == r; }))
+                    accesses.push_back(Access{r, !distrib_read(gen)});
+            }
+
+            unsigned depth = 0;
+            for(Access const& a : accesses)
+                depth = std::max({depth, write_depth[a.resource], a.write ? read_depth[a.resource] : 0u});
+            depth++;
+
+            for(Access const& a : accesses)
+                if(a.write)
+                {
+                    write_depth[a.resource] = depth;
+                    read_depth[a.resource] = 0;
+                }
+                else
+                    read_depth[a.resource] = std::max(read_depth[a.resource], depth);
+
+            critical_path = std::max(critical_path, depth);
+        }
+
+        return {tasks, critical_path};
+    }
+
+    void busy_wait(std::chrono::microseconds duration)
+    {
+        auto const end = std::chrono::steady_clock::now() + duration;
+        while(std::chrono::steady_clock::now() < end)
+            ;
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    auto opt = bench::app::parse(argc, argv);
+    unsigned const n_tasks = opt.get<unsigned>("tasks", 2048);
+    unsigned const n_resources = std::max(1u, opt.get<unsigned>("resources", 64));
+    unsigned const min_deps = opt.get<unsigned>("min_deps", 1);
+    unsigned const max_deps = std::max(min_deps, opt.get<unsigned>("max_deps", 4));
+    double const read_ratio = opt.get<double>("read_ratio", 0.5);
+    auto const duration = std::chrono::microseconds(opt.get<unsigned>("duration_us", 10));
+    unsigned const seed = opt.get<unsigned>("seed", 42);
+
+    auto const generated = generate(n_tasks, n_resources, min_deps, max_deps, read_ratio, seed);
+    auto const& tasks = generated.first;
+    opt.params["critical_path_tasks"] = std::to_string(generated.second);
+
+    return bench::app::run(
+        "random_dag",
+        opt,
+        [&](auto& rg)
+        {
+            std::vector<redGrapes::Resource<redGrapes::access::IOAccess>> resources;
+            for(unsigned r = 0; r < n_resources; ++r)
+                resources.push_back(rg.template createResource<redGrapes::access::IOAccess>());
+
+            return [&rg, &tasks, resources, duration](bench::app::Timer& timer)
+            {
+                timer.start();
+
+                for(auto const& accesses : tasks)
+                {
+                    auto builder = rg.emplace_task([duration] { bench::app::work([&] { busy_wait(duration); }); });
+                    for(Access const& a : accesses)
+                        builder.add_resource(resources[a.resource].make_access(
+                            a.write ? redGrapes::access::IOAccess::write : redGrapes::access::IOAccess::read));
+                }
+
+                return 0.0;
+            };
+        });
+}
@@ -0,0 +1,98 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/* Jacobi iteration of a 5-point stencil on a periodic 2D grid.
+ * The grid is split into `tiles` x `tiles` square tiles of `tile` x `tile` cells,
+ * each of which is updated by one task per step, reading the tile and its four neighbours.
+ *
+ * parameters: tiles=8 tile=128 steps=20
+ */
+
+#include "driver.hpp"
+
+#include <redGrapes/resource/ioresource.hpp>
+
+#include <vector>
+
+using Tile = std::vector<double>;
+
+int main(int argc, char* argv[])
+{
+    auto opt = bench::app::parse(argc, argv);
+    size_t const tiles = std::max<size_t>(3, opt.get<size_t>("tiles", 8));
+    size_t const b = opt.get<size_t>("tile", 128);
+    unsigned const steps = opt.get<unsigned>("steps", 20);
+
+    return bench::app::run(
+        "stencil",
+        opt,
+        [&](auto& rg)
+        {
+            std::vector<std::vector<redGrapes::IOResource<Tile>>> buffers(2);
+            for(auto& buf : buffers)
+                for(size_t t = 0; t < tiles * tiles; ++t)
+                    buf.emplace_back(b * b);
+
+            return [&rg, buffers, tiles, b, steps](bench::app::Timer& timer)
+            {
+                for(auto& buf : buffers)
+                    for(size_t t = 0; t < buf.size(); ++t)
+                        for(size_t i = 0; i < b * b; ++i)
+                            (*buf[t])[i] = double((t * 31 + i) % 17);
+
+                timer.start();
+
+                for(unsigned s = 0; s < steps; ++s)
+                {
+                    auto const& cur = buffers[s % 2];
+                    auto const& next = buffers[(s + 1) % 2];
+
+                    for(size_t ty = 0; ty < tiles; ++ty)
+                        for(size_t tx = 0; tx < tiles; ++tx)
+                        {
+                            auto idx = [tiles](size_t x, size_t y) { return (y % tiles) * tiles + (x % tiles); };
+
+                            rg.emplace_task(
+                                [b](auto dst, auto c, auto n, auto so, auto w, auto e)
+                                {
+                                    bench::app::work(
+                                        [&]
+                                        {
+                                            auto at = [&](long i, long j) -> double
+                                            {
+                                                if(i < 0)
+                                                    return (*n)[(b - 1) * b + j];
+                                                if(i == (long) b)
+                                                    return (*so)[j];
+                                                if(j < 0)
+                                                    return (*w)[i * b + b - 1];
+                                                if(j == (long) b)
+                                                    return (*e)[i * b];
+                                                return (*c)[i * b + j];
+                                            };
+
+                                            for(long i = 0; i < (long) b; ++i)
+                                                for(long j = 0; j < (long) b; ++j)
+                                                    (*dst)[i * b + j] = 0.25
+                                                                        * (at(i - 1, j) + at(i + 1, j) + at(i, j - 1)
+                                                                           + at(i, j + 1));
+                                        });
+                                },
+                                next[idx(tx, ty)].write(),
+                                cur[idx(tx, ty)].read(),
+                                cur[idx(tx, ty + tiles - 1)].read(),
+                                cur[idx(tx, ty + 1)].read(),
+                                cur[idx(tx + tiles - 1, ty)].read(),
+                                cur[idx(tx + 1, ty)].read());
+                        }
+                }
+
+                // three additions and one multiplication per cell
+                return 4.0 * b * b * tiles * tiles * steps;
+            };
+        });
+}
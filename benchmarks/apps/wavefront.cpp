@@ -0,0 +1,96 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/* Dynamic-programming wavefront, like a tiled sequence alignment:
+ * tile (x, y) depends on its left and upper neighbour,
+ * so the available parallelism grows and shrinks along the anti-diagonals.
+ *
+ * parameters: tiles=32 tile=64
+ */
+
+#include "driver.hpp"
+
+#include <redGrapes/resource/ioresource.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+using Tile = std::vector<int32_t>;
+
+namespace
+{
+    /* fill `dst` from its upper and left border,
+     * `up` and `left` may be null at the border of the grid
+     */
+    void compute_tile(Tile& dst, Tile const* up, Tile const* left, size_t b, size_t tx, size_t ty)
+    {
+        for(size_t i = 0; i < b; ++i)
+            for(size_t j = 0; j < b; ++j)
+            {
+                int32_t const n = i > 0 ? dst[(i - 1) * b + j] : (up ? (*up)[(b - 1) * b + j] : 0);
+                int32_t const w = j > 0 ? dst[i * b + j - 1] : (left ? (*left)[i * b + b - 1] : 0);
+                int32_t const match = ((ty * b + i) * 7 + (tx * b + j) * 13) % 5 == 0 ? 2 : -1;
+                dst[i * b + j] = std::max({n - 1, w - 1, std::min(n, w) + match, 0});
+            }
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    auto opt = bench::app::parse(argc, argv);
+    size_t const tiles = opt.get<size_t>("tiles", 32);
+    size_t const b = opt.get<size_t>("tile", 64);
+
+    return bench::app::run(
+        "wavefront",
+        opt,
+        [&](auto& rg)
+        {
+            std::vector<redGrapes::IOResource<Tile>> grid;
+            for(size_t t = 0; t < tiles * tiles; ++t)
+                grid.emplace_back(b * b);
+
+            return [&rg, grid, tiles, b](bench::app::Timer& timer)
+            {
+                timer.start();
+
+                for(size_t ty = 0; ty < tiles; ++ty)
+                    for(size_t tx = 0; tx < tiles; ++tx)
+                    {
+                        auto const& dst = grid[ty * tiles + tx];
+
+                        if(tx > 0 && ty > 0)
+                            rg.emplace_task(
+                                [b, tx, ty](auto dst, auto up, auto left)
+                                { bench::app::work([&] { compute_tile(*dst, &*up, &*left, b, tx, ty); }); },
+                                dst.write(),
+                                grid[(ty - 1) * tiles + tx].read(),
+                                grid[ty * tiles + tx - 1].read());
+                        else if(ty > 0)
+                            rg.emplace_task(
+                                [b, tx, ty](auto dst, auto up)
+                                { bench::app::work([&] { compute_tile(*dst, &*up, nullptr, b, tx, ty); }); },
+                                dst.write(),
+                                grid[(ty - 1) * tiles + tx].read());
+                        else if(tx > 0)
+                            rg.emplace_task(
+                                [b, tx, ty](auto dst, auto left)
+                                { bench::app::work([&] { compute_tile(*dst, nullptr, &*left, b, tx, ty); }); },
+                                dst.write(),
+                                grid[ty * tiles + tx - 1].read());
+                        else
+                            rg.emplace_task(
+                                [b, tx, ty](auto dst)
+                                { bench::app::work([&] { compute_tile(*dst, nullptr, nullptr, b, tx, ty); }); },
+                                dst.write());
+                    }
+
+                return 0.0;
+            };
+        });
+}
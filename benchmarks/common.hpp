@@ -0,0 +1,60 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <thread>
+
+namespace bench
+{
+
+    /* largest number of workers or threads to sweep,
+     * the number of hardware threads or `REDGRAPES_BENCH_MAX_WORKERS` if set
+     */
+    inline unsigned max_workers()
+    {
+        if(char const* env = std::getenv("REDGRAPES_BENCH_MAX_WORKERS"))
+            return std::max(1, std::atoi(env));
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    //! sweep the number of runtime workers in powers of two up to `max_workers()`
+    inline void worker_counts(benchmark::internal::Benchmark* b)
+    {
+        unsigned const n_max = max_workers();
+
+        b->ArgName("workers");
+        for(unsigned n = 1; n < n_max; n *= 2)
+            b->Arg(n);
+        b->Arg(n_max);
+    }
+
+    //! run the benchmark with 1, 2, 4, ... concurrent threads up to `max_workers()`
+    inline void thread_counts(benchmark::internal::Benchmark* b)
+    {
+        unsigned const n_max = max_workers();
+
+        for(unsigned n = 1; n < n_max; n *= 2)
+            b->Threads(n);
+        b->Threads(n_max);
+    }
+
+    //! report the time per item in addition to the throughput
+    inline void set_items(benchmark::State& state, int64_t items_per_iteration)
+    {
+        state.SetItemsProcessed(state.iterations() * items_per_iteration);
+        state.counters["time_per_item"] = benchmark::Counter(
+            items_per_iteration,
+            benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+    }
+
+} // namespace bench
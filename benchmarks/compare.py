@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+# Copyright 2024 The RedGrapes Community
+#
+# This Source Code Form is subject to the terms of the Mozilla Public
+# License, v. 2.0. If a copy of the MPL was not distributed with this
+# file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+"""Compare two sets of results of the application benchmarks (benchmarks/apps).
+
+Each input file holds the JSON written by one or several `bench_<app>` runs,
+either as a single object or a list of objects. Runs are matched by
+application and number of workers, and the median wall time is compared.
+
+The noise of each side is estimated as the relative standard deviation
+from the median absolute deviation (1.4826 * mad / median).
+A difference is only reported as a change if it exceeds both the
+relative `--threshold` and `--sigma` times the combined noise.
+"""
+
+import argparse
+import json
+import math
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        text = f.read()
+
+    try:
+        data = json.loads(text)
+        docs = data if isinstance(data, list) else [data]
+    except json.JSONDecodeError:
+        # concatenated output of several drivers
+        decoder = json.JSONDecoder()
+        docs, pos = [], 0
+        while pos < len(text):
+            if text[pos].isspace():
+                pos += 1
+                continue
+            doc, pos = decoder.raw_decode(text, pos)
+            docs.append(doc)
+
+    results = {}
+    for doc in docs:
+        for run in doc["runs"]:
+            results[(doc["app"], run["workers"])] = run
+    return results
+
+
+def noise(run):
+    if run["median_s"] <= 0:
+        return 0.0
+    return 1.4826 * run["mad_s"] / run["median_s"]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline", help="results of the reference build")
+    parser.add_argument("contender", help="results to compare against the baseline")
+    parser.add_argument(
+        "--threshold", type=float, default=0.05, help="minimal relative change to report (default: 0.05)"
+    )
+    parser.add_argument(
+        "--sigma", type=float, default=3.0, help="minimal change in multiples of the noise (default: 3)"
+    )
+    parser.add_argument(
+        "--fail-on-regression", action="store_true", help="exit with status 1 if any run got slower"
+    )
+    args = parser.parse_args()
+
+    base = load(args.baseline)
+    cont = load(args.contender)
+
+    header = f"{'app':<16} {'workers':>7} {'base [ms]':>12} {'new [ms]':>12} {'change':>9} {'noise':>8}  verdict"
+    print(header)
+    print("-" * len(header))
+
+    regressions = 0
+    for key in sorted(base.keys() & cont.keys()):
+        b, c = base[key], cont[key]
+        change = c["median_s"] / b["median_s"] - 1.0
+        combined = math.sqrt(noise(b) ** 2 + noise(c) ** 2)
+
+        if abs(change) <= max(args.threshold, args.sigma * combined):
+            verdict = "unchanged"
+        elif change < 0:
+            verdict = "faster"
+        else:
+            verdict = "SLOWER"
+            regressions += 1
+
+        print(
+            f"{key[0]:<16} {key[1]:>7} {b['median_s'] * 1e3:>12.3f} {c['median_s'] * 1e3:>12.3f}"
+            f" {change:>+8.1%} {combined:>8.1%}  {verdict}"
+        )
+
+    for key in sorted(base.keys() ^ cont.keys()):
+        print(f"{key[0]:<16} {key[1]:>7}  only in {'baseline' if key in base else 'contender'}")
+
+    if regressions:
+        print(f"\n{regressions} regression(s)")
+    return 1 if regressions and args.fail_on_regression else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
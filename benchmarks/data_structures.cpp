@@ -0,0 +1,368 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/* Benchmarks of the concurrent data structures below every task,
+ * run with 1, 2, 4, ... threads (see `bench::thread_counts()`).
+ *
+ * The `ChunkedList` cases are instantiated for several chunk sizes
+ * in order to choose `REDGRAPES_RUL_CHUNKSIZE` (resource user lists)
+ * and `REDGRAPES_EVENT_FOLLOWER_LIST_CHUNKSIZE` (follower lists of events).
+ * Lists and chunks are allocated with `malloc` here, so that
+ * the numbers are independent of the worker arenas.
+ */
+
+#include "common.hpp"
+
+#include <redGrapes/TaskFreeCtx.hpp>
+#include <redGrapes/memory/block.hpp>
+#include <redGrapes/task/queue.hpp>
+#include <redGrapes/util/atomic_list.hpp>
+#include <redGrapes/util/chunked_list.hpp>
+
+#include <benchmark/benchmark.h>
+#include <moodycamel/concurrentqueue.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    struct MallocAlloc
+    {
+        redGrapes::memory::Block allocate(std::size_t n_bytes) noexcept
+        {
+            return redGrapes::memory::Block{(uintptr_t) std::malloc(n_bytes), n_bytes};
+        }
+
+        void deallocate(redGrapes::memory::Block blk) noexcept
+        {
+            std::free((void*) blk.ptr);
+        }
+    };
+
+    //! number of elements each thread inserts before removing them again
+    constexpr int64_t batch_size = 64;
+
+    //! number of elements which stay in the list during the iteration benchmark
+    constexpr int64_t n_resident = 1024;
+
+    void* item(int64_t i)
+    {
+        return (void*) (uintptr_t) (i + 1);
+    }
+
+} // namespace
+
+/* every thread pushes a batch of items and removes them again,
+ * like tasks which register at a resource and leave it when done
+ */
+template<size_t T_chunk_size>
+static void BM_ChunkedListPushRemove(benchmark::State& state)
+{
+    using List = redGrapes::ChunkedList<void*, T_chunk_size, MallocAlloc>;
+    static List* list;
+
+    if(state.thread_index() == 0)
+        list = new List(MallocAlloc{});
+
+    std::vector<typename List::MutBackwardIterator> pos;
+    pos.reserve(batch_size);
+
+    for(auto _ : state)
+    {
+        for(int64_t i = 0; i < batch_size; ++i)
+            pos.push_back(list->push(item(i)));
+        for(auto& p : pos)
+            list->remove(p);
+        pos.clear();
+    }
+
+    if(state.thread_index() == 0)
+        delete list;
+
+    bench::set_items(state, 2 * batch_size);
+}
+
+BENCHMARK_TEMPLATE(BM_ChunkedListPushRemove, 8)->Apply(bench::thread_counts)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ChunkedListPushRemove, 16)->Apply(bench::thread_counts)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ChunkedListPushRemove, 32)->Apply(bench::thread_counts)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ChunkedListPushRemove, 64)->Apply(bench::thread_counts)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ChunkedListPushRemove, 128)->Apply(bench::thread_counts)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ChunkedListPushRemove, 256)->Apply(bench::thread_counts)->UseRealTime();
+
+/* the first thread iterates backwards over a list with `n_resident` items,
+ * like the dependency search of a new task, while all other threads
+ * concurrently push and remove items.
+ * Only the iterated items are counted.
+ */
+template<size_t T_chunk_size>
+static void BM_ChunkedListIterate(benchmark::State& state)
+{
+    using List = redGrapes::ChunkedList<void*, T_chunk_size, MallocAlloc>;
+    static List* list;
+
+    if(state.thread_index() == 0)
+    {
+        list = new List(MallocAlloc{});
+        for(int64_t i = 0; i < n_resident; ++i)
+            list->push(item(i));
+    }
+
+    std::vector<typename List::MutBackwardIterator> pos;
+    pos.reserve(batch_size);
+    int64_t n_visited = 0;
+
+    for(auto _ : state)
+    {
+        if(state.thread_index() == 0)
+        {
+            for(auto it = list->rbegin(); it != list->rend(); ++it)
+            {
+                benchmark::DoNotOptimize(*it);
+                ++n_visited;
+            }
+        }
+        else
+        {
+            for(int64_t i = 0; i < batch_size; ++i)
+                pos.push_back(list->push(item(i)));
+            for(auto& p : pos)
+                list->remove(p);
+            pos.clear();
+        }
+    }
+
+    if(state.thread_index() == 0)
+        delete list;
+
+    state.SetItemsProcessed(n_visited);
+}
+
+BENCHMARK_TEMPLATE(BM_ChunkedListIterate, 8)->Apply(bench::thread_counts)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ChunkedListIterate, 16)->Apply(bench::thread_counts)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ChunkedListIterate, 32)->Apply(bench::thread_counts)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ChunkedListIterate, 64)->Apply(bench::thread_counts)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ChunkedListIterate, 128)->Apply(bench::thread_counts)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ChunkedListIterate, 256)->Apply(bench::thread_counts)->UseRealTime();
+
+namespace
+{
+    //! chunk content of the `AtomicList` benchmark
+    struct Payload
+    {
+        Payload(redGrapes::memory::Block)
+        {
+        }
+    };
+} // namespace
+
+/* every thread appends chunks and erases the chunk which was head before,
+ * like `ChunkedBumpAlloc` and `ChunkedList` do when a chunk is full
+ */
+static void BM_AtomicListAppendErase(benchmark::State& state)
+{
+    using List = redGrapes::memory::AtomicList<Payload, MallocAlloc>;
+    static List* list;
+
+    if(state.thread_index() == 0)
+        list = new List(MallocAlloc{}, 256);
+
+    int64_t n = 0;
+    for(auto _ : state)
+    {
+        auto prev = list->allocate_item();
+        if(prev != list->rend())
+            list->erase(prev);
+
+        // erased chunks are only unlinked by iterating
+        if(++n % batch_size == 0)
+            list->unlink_erased();
+    }
+
+    if(state.thread_index() == 0)
+        delete list;
+
+    bench::set_items(state, 1);
+}
+
+BENCHMARK(BM_AtomicListAppendErase)->Apply(bench::thread_counts)->UseRealTime();
+
+namespace
+{
+    struct DummyTask
+    {
+    };
+} // namespace
+
+//! all threads push a batch into a shared ready queue and pop the same number of tasks
+static void BM_TaskQueue(benchmark::State& state)
+{
+    using Queue = redGrapes::task::Queue<DummyTask>;
+    static Queue* queue;
+
+    if(state.thread_index() == 0)
+        queue = new Queue(1024);
+
+    DummyTask task;
+    for(auto _ : state)
+    {
+        for(int64_t i = 0; i < batch_size; ++i)
+            queue->push(&task);
+        for(int64_t i = 0; i < batch_size;)
+            if(queue->pop())
+                ++i;
+    }
+
+    if(state.thread_index() == 0)
+        delete queue;
+
+    bench::set_items(state, 2 * batch_size);
+}
+
+BENCHMARK(BM_TaskQueue)->Apply(bench::thread_counts)->UseRealTime();
+
+namespace
+{
+    //! worker arena of the calling thread, like the ones created by the schedulers
+    redGrapes::WorkerAlloc make_arena(int thread_index)
+    {
+        using namespace redGrapes;
+        hwloc_obj_t obj = hwloc_get_obj_by_type(
+            TaskFreeCtx::hwloc_ctx.topology,
+            HWLOC_OBJ_PU,
+            thread_index % TaskFreeCtx::n_pus);
+        return WorkerAlloc(memory::ChunkCache<memory::HwlocAlloc>(memory::HwlocAlloc(TaskFreeCtx::hwloc_ctx, obj)));
+    }
+
+    struct MallocArena
+    {
+        redGrapes::memory::Block allocate(size_t n_bytes)
+        {
+            return MallocAlloc{}.allocate(n_bytes);
+        }
+
+        void deallocate(redGrapes::memory::Block blk)
+        {
+            MallocAlloc{}.deallocate(blk);
+        }
+
+        void deallocate_remote(redGrapes::memory::Block blk)
+        {
+            MallocAlloc{}.deallocate(blk);
+        }
+    };
+
+    template<typename Arena>
+    Arena make(int thread_index)
+    {
+        if constexpr(std::is_same_v<Arena, MallocArena>)
+            return MallocArena{};
+        else
+            return make_arena(thread_index);
+    }
+
+} // namespace
+
+//! every thread allocates a batch of blocks of `state.range(0)` bytes from its own arena and frees it again
+template<typename Arena>
+static void BM_AllocLocal(benchmark::State& state)
+{
+    Arena arena = make<Arena>(state.thread_index());
+    size_t const n_bytes = state.range(0);
+    std::vector<redGrapes::memory::Block> blocks(batch_size);
+
+    for(auto _ : state)
+    {
+        for(auto& blk : blocks)
+        {
+            blk = arena.allocate(n_bytes);
+            benchmark::DoNotOptimize(blk.ptr);
+        }
+        for(auto& blk : blocks)
+            arena.deallocate(blk);
+    }
+
+    bench::set_items(state, batch_size);
+}
+
+BENCHMARK_TEMPLATE(BM_AllocLocal, redGrapes::WorkerAlloc)
+    ->ArgName("bytes")
+    ->Arg(64)
+    ->Arg(256)
+    ->Arg(2048)
+    ->Apply(bench::thread_counts)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_AllocLocal, MallocArena)
+    ->ArgName("bytes")
+    ->Arg(64)
+    ->Arg(256)
+    ->Arg(2048)
+    ->Apply(bench::thread_counts)
+    ->UseRealTime();
+
+/* every thread allocates a batch from its own arena and passes the blocks
+ * through a shared queue, then frees the same number of blocks taken from the queue,
+ * which were mostly allocated by other threads.
+ * The queue is the same for both allocators, so only the difference of the results is meaningful.
+ */
+template<typename Arena>
+static void BM_AllocRemote(benchmark::State& state)
+{
+    using Handoff = moodycamel::ConcurrentQueue<std::pair<Arena*, redGrapes::memory::Block>>;
+    static Handoff* handoff;
+
+    if(state.thread_index() == 0)
+        handoff = new Handoff(1024);
+
+    Arena arena = make<Arena>(state.thread_index());
+    size_t const n_bytes = state.range(0);
+    int64_t n_remote = 0;
+
+    for(auto _ : state)
+    {
+        for(int64_t i = 0; i < batch_size; ++i)
+            handoff->enqueue({&arena, arena.allocate(n_bytes)});
+
+        std::pair<Arena*, redGrapes::memory::Block> blk;
+        for(int64_t i = 0; i < batch_size;)
+            if(handoff->try_dequeue(blk))
+            {
+                if(blk.first == &arena)
+                    arena.deallocate(blk.second);
+                else
+                {
+                    blk.first->deallocate_remote(blk.second);
+                    ++n_remote;
+                }
+                ++i;
+            }
+    }
+
+    // every thread took as many blocks as it passed on, so the queue is empty again
+    if(state.thread_index() == 0)
+        delete handoff;
+
+    bench::set_items(state, batch_size);
+    state.counters["remote_frees"] = benchmark::Counter(n_remote, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK_TEMPLATE(BM_AllocRemote, redGrapes::WorkerAlloc)
+    ->ArgName("bytes")
+    ->Arg(64)
+    ->Arg(256)
+    ->Apply(bench::thread_counts)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_AllocRemote, MallocArena)
+    ->ArgName("bytes")
+    ->Arg(64)
+    ->Arg(256)
+    ->Apply(bench::thread_counts)
+    ->UseRealTime();
@@ -0,0 +1,137 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/* CPU time consumed by an MPI worker while it has nothing to do
+ * and while it waits for a single outstanding request.
+ *
+ * Every rank runs one default worker and one MPI worker.
+ *
+ *   idle    - the runtime is left alone for `idle_ms`
+ *   request - rank 0 posts an MPI_Irecv which rank 1 only matches after `delay_ms`,
+ *             so the MPI worker of rank 0 polls for the whole period
+ *
+ * For both phases the user and system time of the process (getrusage) is printed per rank.
+ * `bench_mpi_idle_spin` is the same program built with an unlimited spin budget for the
+ * condition variables and the poll backoff, i.e. workers which never go to sleep.
+ *
+ * Command line: `mpirun -n 2 bench_mpi_idle idle_ms=2000 delay_ms=1000`
+ */
+
+#include "apps/driver.hpp"
+
+#include <redGrapes/SchedulerDescription.hpp>
+#include <redGrapes/dispatch/mpi/mpiWorker.hpp>
+#include <redGrapes/redGrapes.hpp>
+#include <redGrapes/scheduler/mpi_thread_scheduler.hpp>
+#include <redGrapes/scheduler/pool_scheduler.hpp>
+
+#include <mpi.h>
+#include <sys/resource.h>
+
+#include <chrono>
+#include <thread>
+
+namespace
+{
+    struct MPITag
+    {
+    };
+
+    //! user and system time of the whole process in seconds
+    double process_cpu_s()
+    {
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec
+               + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+    }
+
+    //! CPU time of the process while the calling thread sleeps for `duration`
+    double cpu_during_sleep(std::chrono::milliseconds duration)
+    {
+        double const begin = process_cpu_s();
+        std::this_thread::sleep_for(duration);
+        return process_cpu_s() - begin;
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    auto opt = bench::app::parse(argc, argv);
+    auto const idle = std::chrono::milliseconds(opt.get<unsigned>("idle_ms", 2000));
+    auto const delay = std::chrono::milliseconds(opt.get<unsigned>("delay_ms", 1000));
+
+    using RGTask = redGrapes::Task<>;
+    auto rg = redGrapes::init(
+        redGrapes::SchedulerDescription(
+            std::make_shared<redGrapes::scheduler::PoolScheduler<redGrapes::dispatch::thread::DefaultWorker<RGTask>>>(
+                1),
+            redGrapes::DefaultTag{}),
+        redGrapes::SchedulerDescription(
+            std::make_shared<redGrapes::scheduler::MPIThreadScheduler<RGTask>>(),
+            MPITag{}));
+
+    auto request_pool = rg.getScheduler<MPITag>().getRequestPool();
+
+    int rank = 0;
+    rg.emplace_task<MPITag>(
+          [&rank]
+          {
+              int provided;
+              MPI_Init_thread(nullptr, nullptr, MPI_THREAD_FUNNELED, &provided);
+              MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+          })
+        .get();
+
+    rg.emplace_task<MPITag>([] { MPI_Barrier(MPI_COMM_WORLD); }).get();
+    double const idle_cpu = cpu_during_sleep(idle);
+
+    rg.emplace_task<MPITag>([] { MPI_Barrier(MPI_COMM_WORLD); }).get();
+    int value = 0;
+    double request_cpu;
+    if(rank == 0)
+    {
+        auto recv = rg.emplace_task<MPITag>(
+                          [&value, request_pool]
+                          {
+                              MPI_Request request;
+                              MPI_Irecv(&value, 1, MPI_INT, 1, 0, MPI_COMM_WORLD, &request);
+                              request_pool->get_status(request);
+                          })
+                        .enable_stack_switching();
+
+        // the receive completes after `delay`, the remaining time the worker is idle again
+        request_cpu = cpu_during_sleep(delay + delay / 10);
+        recv.get();
+    }
+    else
+    {
+        double const begin = process_cpu_s();
+        std::this_thread::sleep_for(delay);
+        if(rank == 1)
+            rg.emplace_task<MPITag>(
+                  [&value]
+                  {
+                      value = 1;
+                      MPI_Send(&value, 1, MPI_INT, 0, 0, MPI_COMM_WORLD);
+                  })
+                .get();
+        std::this_thread::sleep_for(delay / 10);
+        request_cpu = process_cpu_s() - begin;
+    }
+
+    fmt::print(
+        "rank {}: idle {:.3f} s cpu in {:.3f} s, request {:.3f} s cpu in {:.3f} s\n",
+        rank,
+        idle_cpu,
+        idle.count() * 1e-3,
+        request_cpu,
+        (delay + delay / 10).count() * 1e-3);
+
+    rg.emplace_task<MPITag>([] { MPI_Finalize(); }).get();
+    return 0;
+}
@@ -0,0 +1,205 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/* Micro-benchmarks for the overheads of the runtime itself.
+ * All tasks are (nearly) empty, so the measured time is spent
+ * in task creation, dependency detection, scheduling and synchronization.
+ *
+ * Every case is run once per worker count, see `bench::worker_counts()`.
+ * Use `--benchmark_format=json` or `--benchmark_out=<file>` for machine-readable results.
+ */
+
+#include "common.hpp"
+
+#include <redGrapes/redGrapes.hpp>
+#include <redGrapes/resource/fieldresource.hpp>
+#include <redGrapes/resource/ioresource.hpp>
+
+#include <benchmark/benchmark.h>
+#include <spdlog/spdlog.h>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+    auto init_runtime(benchmark::State const& state)
+    {
+        spdlog::set_level(spdlog::level::off);
+        return redGrapes::init(static_cast<redGrapes::WorkerId>(state.range(0)));
+    }
+
+    void busy_wait(std::chrono::nanoseconds duration)
+    {
+        auto const end = std::chrono::steady_clock::now() + duration;
+        while(std::chrono::steady_clock::now() < end)
+            ;
+    }
+
+} // namespace
+
+//! throughput of independent, empty tasks
+static void BM_EmptyTaskSpawn(benchmark::State& state)
+{
+    auto rg = init_runtime(state);
+    int64_t const n_tasks = 1024;
+
+    for(auto _ : state)
+    {
+        for(int64_t i = 0; i < n_tasks; ++i)
+            rg.emplace_task([] {});
+        rg.barrier();
+    }
+
+    bench::set_items(state, n_tasks);
+}
+
+BENCHMARK(BM_EmptyTaskSpawn)->Apply(bench::worker_counts)->UseRealTime();
+
+//! latency from the end of one task to the start of its successor
+static void BM_DependencyChain(benchmark::State& state)
+{
+    auto rg = init_runtime(state);
+    auto a = rg.createIOResource<uint64_t>(0);
+    int64_t const length = 256;
+
+    for(auto _ : state)
+    {
+        for(int64_t i = 0; i < length; ++i)
+            rg.emplace_task([](auto a) { ++*a; }, a.write());
+        rg.barrier();
+    }
+
+    bench::set_items(state, length);
+}
+
+BENCHMARK(BM_DependencyChain)->Apply(bench::worker_counts)->UseRealTime();
+
+/* one task initializes a field, `width` tasks each write one element
+ * of it and a last task reads the whole field
+ */
+static void BM_FanOutFanIn(benchmark::State& state)
+{
+    auto rg = init_runtime(state);
+    size_t const width = 256;
+    redGrapes::FieldResource<std::vector<uint64_t>> field(width);
+
+    for(auto _ : state)
+    {
+        rg.emplace_task([](auto f) { f[{0}] = 0; }, field.write());
+
+        for(size_t i = 0; i < width; ++i)
+            rg.emplace_task([i](auto f) { f[{i}] = i; }, field.write().at({i}));
+
+        rg.emplace_task([](auto f) { benchmark::DoNotOptimize(f[{0}]); }, field.read());
+        rg.barrier();
+    }
+
+    bench::set_items(state, width + 2);
+}
+
+BENCHMARK(BM_FanOutFanIn)->Apply(bench::worker_counts)->UseRealTime();
+
+//! many readers following a single writer, repeated over several rounds
+static void BM_ReadBroadcast(benchmark::State& state)
+{
+    auto rg = init_runtime(state);
+    auto a = rg.createIOResource<uint64_t>(0);
+    int64_t const rounds = 16;
+    int64_t const readers = 64;
+
+    for(auto _ : state)
+    {
+        for(int64_t r = 0; r < rounds; ++r)
+        {
+            rg.emplace_task([](auto a) { ++*a; }, a.write());
+            for(int64_t i = 0; i < readers; ++i)
+                rg.emplace_task([](auto a) { benchmark::DoNotOptimize(*a); }, a.read());
+        }
+        rg.barrier();
+    }
+
+    bench::set_items(state, rounds * (readers + 1));
+}
+
+BENCHMARK(BM_ReadBroadcast)->Apply(bench::worker_counts)->UseRealTime();
+
+/* Tasks are distributed round-robin, but every `workers`-th task is long,
+ * so one worker receives all the long tasks and the others have to steal.
+ */
+static void BM_StealThroughput(benchmark::State& state)
+{
+    auto rg = init_runtime(state);
+    int64_t const n_workers = state.range(0);
+    int64_t const n_tasks = 256;
+    auto const long_task = std::chrono::microseconds(20);
+
+    rg.reset_scheduler_stats();
+    for(auto _ : state)
+    {
+        for(int64_t i = 0; i < n_tasks; ++i)
+            if(i % n_workers == 0)
+                rg.emplace_task([long_task] { busy_wait(long_task); });
+            else
+                rg.emplace_task([] {});
+        rg.barrier();
+    }
+
+    redGrapes::scheduler::SchedulerStats total;
+    for(auto const& s : rg.scheduler_stats())
+        total += s;
+
+    bench::set_items(state, n_tasks);
+    state.counters["steals"] = benchmark::Counter(
+        total.steal_ready_successes + total.steal_new_successes,
+        benchmark::Counter::kAvgIterations);
+    state.counters["steal_attempts"] = benchmark::Counter(
+        total.steal_ready_attempts + total.steal_new_attempts,
+        benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_StealThroughput)->Apply(bench::worker_counts)->UseRealTime();
+
+//! submit a task from the main thread and wait for its result
+static void BM_FutureGet(benchmark::State& state)
+{
+    auto rg = init_runtime(state);
+    uint64_t i = 0;
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(rg.emplace_task([i] { return i + 1; }).get());
+
+    rg.barrier();
+    bench::set_items(state, 1);
+}
+
+BENCHMARK(BM_FutureGet)->Apply(bench::worker_counts)->UseRealTime();
+
+//! parent tasks which each create a child task space by spawning children
+static void BM_ChildTaskSpace(benchmark::State& state)
+{
+    auto rg = init_runtime(state);
+    int64_t const n_parents = 64;
+    int64_t const n_children = 8;
+
+    for(auto _ : state)
+    {
+        for(int64_t p = 0; p < n_parents; ++p)
+            rg.emplace_task(
+                [&rg, n_children]
+                {
+                    for(int64_t c = 0; c < n_children; ++c)
+                        rg.emplace_task([] {});
+                });
+        rg.barrier();
+    }
+
+    bench::set_items(state, n_parents * (n_children + 1));
+}
+
+BENCHMARK(BM_ChildTaskSpace)->Apply(bench::worker_counts)->UseRealTime();
@@ -0,0 +1,158 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/* Replays a recorded task graph (REDGRAPES_TASK_GRAPH=graph.json) on the real runtime.
+ *
+ * Every task is emplaced again with the same resource accesses and a body which
+ * busy-waits for the recorded duration, so the application kernels are taken out
+ * and only the scheduling behaviour remains. Top-level tasks are submitted at their
+ * recorded times, or all at once with `release=zero`, and child tasks are emplaced
+ * by their parent at the recorded offset from its start.
+ *
+ * The lower bound max(critical path, work / workers) is reported as `ideal_s`
+ * together with the ratio of the measured wall time to it.
+ *
+ * parameters: graph=graph.json release=recorded|zero scale=1.0
+ */
+
+#include "../apps/driver.hpp"
+#include "task_graph.hpp"
+
+#include <redGrapes/resource/resource.hpp>
+
+#include <map>
+#include <vector>
+
+namespace
+{
+    using redGrapes::TscClock;
+
+    void spin_until(uint64_t deadline)
+    {
+        while(TscClock::now() < deadline)
+            ;
+    }
+
+    template<typename RG>
+    struct Replay
+    {
+        RG& rg;
+        sim::TaskGraph const& graph;
+        std::vector<std::vector<size_t>> const& children;
+        std::vector<redGrapes::Resource<redGrapes::access::IOAccess>> const& resources;
+
+        //! recorded resource id to index in `resources`
+        std::map<unsigned, size_t> const& resource_index;
+
+        double ticks_per_ns;
+
+        uint64_t ticks(uint64_t ns) const
+        {
+            return uint64_t(ns * ticks_per_ns);
+        }
+
+        void emplace(size_t i)
+        {
+            auto builder = rg.emplace_task([this, i] { bench::app::work([&] { body(i); }); });
+            for(sim::TaskGraph::Access const& a : graph.tasks[i].accesses)
+                builder.add_resource(resources[resource_index.at(a.resource)].make_access(
+                    a.write ? redGrapes::access::IOAccess::write : redGrapes::access::IOAccess::read));
+        }
+
+        void body(size_t i)
+        {
+            uint64_t const begin = TscClock::now();
+            uint64_t const duration = graph.tasks[i].duration_ns;
+
+            for(size_t c : children[i])
+            {
+                spin_until(begin + ticks(std::min(graph.tasks[c].release_ns, duration)));
+                emplace(c);
+            }
+            spin_until(begin + ticks(duration));
+        }
+    };
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    auto opt = bench::app::parse(argc, argv);
+    std::string const path = opt.get<std::string>("graph", "graph.json");
+    bool const keep_release = opt.get<std::string>("release", "recorded") != "zero";
+    double const scale = opt.get<double>("scale", 1.0);
+
+    sim::TaskGraph graph;
+    try
+    {
+        graph = sim::load(path, keep_release);
+    }
+    catch(std::exception const& e)
+    {
+        fmt::print(stderr, "could not load {}: {}\n", path, e.what());
+        return 1;
+    }
+
+    for(sim::TaskGraph::Task& t : graph.tasks)
+    {
+        t.duration_ns = uint64_t(t.duration_ns * scale);
+        t.release_ns = uint64_t(t.release_ns * scale);
+    }
+
+    std::vector<std::vector<size_t>> children(graph.size());
+    std::vector<size_t> roots;
+    std::map<unsigned, size_t> resource_index;
+    for(size_t i = 0; i < graph.size(); ++i)
+    {
+        if(auto parent = graph.tasks[i].parent)
+            children[*parent].push_back(i);
+        else
+            roots.push_back(i);
+
+        for(sim::TaskGraph::Access const& a : graph.tasks[i].accesses)
+            resource_index.emplace(a.resource, resource_index.size());
+    }
+
+    uint64_t const work_ns = graph.total_work_ns();
+    uint64_t const critical_path_ns = graph.critical_path_ns();
+    opt.params["tasks"] = std::to_string(graph.size());
+    opt.params["work_ns"] = std::to_string(work_ns);
+    opt.params["critical_path_ns"] = std::to_string(critical_path_ns);
+    opt.ideal_s = [=](unsigned workers) { return std::max(critical_path_ns, work_ns / workers) * 1e-9; };
+
+    return bench::app::run(
+        "replay",
+        opt,
+        [&](auto& rg)
+        {
+            std::vector<redGrapes::Resource<redGrapes::access::IOAccess>> resources;
+            for(size_t r = 0; r < resource_index.size(); ++r)
+                resources.push_back(rg.template createResource<redGrapes::access::IOAccess>());
+
+            return [&rg, &graph, &children, &roots, &resource_index, resources](bench::app::Timer& timer)
+            {
+                Replay<std::remove_reference_t<decltype(rg)>> replay{
+                    rg,
+                    graph,
+                    children,
+                    resources,
+                    resource_index,
+                    1.0 / TscClock::ns_per_tick()};
+
+                timer.start();
+                uint64_t const begin = TscClock::now();
+                for(size_t i : roots)
+                {
+                    spin_until(begin + replay.ticks(graph.tasks[i].release_ns));
+                    replay.emplace(i);
+                }
+
+                // the tasks refer to `replay`
+                rg.barrier();
+                return 0.0;
+            };
+        });
+}
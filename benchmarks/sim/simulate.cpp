@@ -0,0 +1,267 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/* Replays a recorded task graph through every combination of the given policies
+ * and worker counts in the simulator and reports makespan, utilization and waiting times.
+ *
+ *   REDGRAPES_TASK_GRAPH=graph.json ./my_app
+ *   ./benchmarks/bench_simulate graph.json --workers=4,16 --placement=runtime,locality \
+ *       --steal=next_busy,random --priority=fifo,critical_path --overhead_ns=500
+ *
+ * Policies: placement runtime|round_robin|first_free|locality,
+ *           steal none|next_busy|random|most_loaded,
+ *           priority fifo|lifo|critical_path.
+ * `--release=zero` releases all tasks at once instead of at their recorded submission times,
+ * `--notify_idle` additionally wakes an idle worker for every task put into a busy worker's queue.
+ * `--tasks=file.csv` writes the schedule of every task, `--json=file` the summary.
+ */
+
+#include "simulator.hpp"
+
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+    std::vector<std::string> split(std::string const& s)
+    {
+        std::vector<std::string> items;
+        std::istringstream in(s);
+        for(std::string item; std::getline(in, item, ',');)
+            if(!item.empty())
+                items.push_back(item);
+        return items;
+    }
+
+    struct Summary
+    {
+        unsigned workers;
+        std::string placement, steal, priority;
+        sim::Result result;
+
+        double mean_wait_ns = 0.0;
+        uint64_t max_wait_ns = 0;
+
+        //! waiting time summed over the tasks without slack, which directly extends the makespan
+        uint64_t critical_wait_ns = 0;
+    };
+
+    void usage(char const* argv0)
+    {
+        fmt::print(
+            stderr,
+            "usage: {} graph.json [--workers=1,2,4] [--placement=runtime,...] [--steal=next_busy,...] "
+            "[--priority=fifo,...] [--overhead_ns=0] [--steal_ns=0] [--notify_idle] [--release=recorded|zero] "
+            "[--tasks=file.csv] [--json=file]\n",
+            argv0);
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::string graph_path, tasks_path, json_path;
+    std::vector<unsigned> workers{1, 2, 4, 8};
+    std::vector<std::string> placements{"runtime"}, steals{"next_busy"}, priorities{"fifo"};
+    sim::Config config;
+    bool keep_release = true;
+
+    for(int i = 1; i < argc; ++i)
+    {
+        std::string const arg = argv[i];
+        auto const eq = arg.find('=');
+        std::string const key = arg.substr(0, eq);
+        std::string const value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+        if(key == "--workers")
+        {
+            workers.clear();
+            for(auto const& w : split(value))
+                workers.push_back(std::max(1, std::atoi(w.c_str())));
+        }
+        else if(key == "--placement")
+            placements = split(value);
+        else if(key == "--steal")
+            steals = split(value);
+        else if(key == "--priority")
+            priorities = split(value);
+        else if(key == "--overhead_ns")
+            config.overhead_ns = std::strtoull(value.c_str(), nullptr, 10);
+        else if(key == "--steal_ns")
+            config.steal_ns = std::strtoull(value.c_str(), nullptr, 10);
+        else if(key == "--notify_idle")
+            config.notify_idle = true;
+        else if(key == "--release")
+            keep_release = value != "zero";
+        else if(key == "--tasks")
+            tasks_path = value;
+        else if(key == "--json")
+            json_path = value;
+        else if(key.rfind("--", 0) != 0 && graph_path.empty())
+            graph_path = arg;
+        else
+        {
+            usage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    if(graph_path.empty())
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    sim::TaskGraph graph;
+    try
+    {
+        graph = sim::load(graph_path, keep_release);
+    }
+    catch(std::exception const& e)
+    {
+        fmt::print(stderr, "could not load {}: {}\n", graph_path, e.what());
+        return 1;
+    }
+
+    std::vector<Summary> summaries;
+    for(unsigned n : workers)
+        for(auto const& placement_name : placements)
+            for(auto const& steal_name : steals)
+                for(auto const& priority_name : priorities)
+                {
+                    auto placement = sim::policy::make_placement(placement_name);
+                    auto steal = sim::policy::make_steal(steal_name);
+                    auto priority = sim::policy::make_priority(priority_name);
+                    if(!placement || !steal || !priority)
+                    {
+                        fmt::print(
+                            stderr,
+                            "unknown policy in {}/{}/{}\n",
+                            placement_name,
+                            steal_name,
+                            priority_name);
+                        return 1;
+                    }
+
+                    config.workers = n;
+                    Summary s{n, placement_name, steal_name, priority_name, {}};
+                    s.result = sim::Simulator(graph, config, *placement, *steal, *priority).run();
+
+                    for(sim::TaskResult const& t : s.result.tasks)
+                    {
+                        uint64_t const wait = t.start - t.ready;
+                        s.mean_wait_ns += wait;
+                        s.max_wait_ns = std::max(s.max_wait_ns, wait);
+                        if(t.slack == 0)
+                            s.critical_wait_ns += wait;
+                    }
+                    if(!s.result.tasks.empty())
+                        s.mean_wait_ns /= s.result.tasks.size();
+
+                    summaries.push_back(std::move(s));
+                }
+
+    // best policies first for each number of workers
+    std::stable_sort(
+        summaries.begin(),
+        summaries.end(),
+        [](Summary const& a, Summary const& b)
+        {
+            return a.workers != b.workers ? a.workers < b.workers : a.result.makespan_ns < b.result.makespan_ns;
+        });
+
+    fmt::print(
+        "{} tasks, {:.3f} ms of work\n\n{:>7} {:<12} {:<12} {:<14} {:>13} {:>8} {:>8} {:>8} {:>13}\n",
+        graph.size(),
+        graph.total_work_ns() * 1e-6,
+        "workers",
+        "placement",
+        "steal",
+        "priority",
+        "makespan [ms]",
+        "util.",
+        "effic.",
+        "steals",
+        "crit.wait[ms]");
+    for(Summary const& s : summaries)
+        fmt::print(
+            "{:>7} {:<12} {:<12} {:<14} {:>13.3f} {:>7.1f}% {:>7.1f}% {:>8} {:>13.3f}\n",
+            s.workers,
+            s.placement,
+            s.steal,
+            s.priority,
+            s.result.makespan_ns * 1e-6,
+            s.result.utilization(s.workers) * 100.0,
+            s.result.efficiency() * 100.0,
+            s.result.steals,
+            s.critical_wait_ns * 1e-6);
+
+    if(!tasks_path.empty())
+    {
+        std::ofstream out(tasks_path);
+        out << "workers,placement,steal,priority,task,label,worker,ready_ns,start_ns,end_ns,wait_ns,slack_ns,stolen\n";
+        for(Summary const& s : summaries)
+            for(size_t i = 0; i < s.result.tasks.size(); ++i)
+            {
+                sim::TaskResult const& t = s.result.tasks[i];
+                out << fmt::format(
+                    "{},{},{},{},{},\"{}\",{},{},{},{},{},{},{}\n",
+                    s.workers,
+                    s.placement,
+                    s.steal,
+                    s.priority,
+                    graph.tasks[i].id,
+                    graph.tasks[i].label,
+                    t.worker,
+                    t.ready,
+                    t.start,
+                    t.end,
+                    t.start - t.ready,
+                    t.slack,
+                    t.stolen ? 1 : 0);
+            }
+    }
+
+    if(!json_path.empty())
+    {
+        std::vector<std::string> runs;
+        for(Summary const& s : summaries)
+            runs.push_back(fmt::format(
+                "{{\"workers\": {}, \"placement\": \"{}\", \"steal\": \"{}\", \"priority\": \"{}\", "
+                "\"makespan_ns\": {}, \"lower_bound_ns\": {}, \"utilization\": {:.4f}, \"efficiency\": {:.4f}, "
+                "\"steals\": {}, \"mean_wait_ns\": {:.0f}, \"max_wait_ns\": {}, \"critical_wait_ns\": {}}}",
+                s.workers,
+                s.placement,
+                s.steal,
+                s.priority,
+                s.result.makespan_ns,
+                s.result.lower_bound_ns,
+                s.result.utilization(s.workers),
+                s.result.efficiency(),
+                s.result.steals,
+                s.mean_wait_ns,
+                s.max_wait_ns,
+                s.critical_wait_ns));
+
+        std::ofstream out(json_path);
+        out << fmt::format(
+            "{{\n  \"graph\": \"{}\",\n  \"tasks\": {},\n  \"work_ns\": {},\n  \"overhead_ns\": {},\n"
+            "  \"steal_ns\": {},\n  \"runs\": [\n    {}\n  ]\n}}\n",
+            graph_path,
+            graph.size(),
+            graph.total_work_ns(),
+            config.overhead_ns,
+            config.steal_ns,
+            fmt::join(runs, ",\n    "));
+    }
+
+    return 0;
+}
@@ -0,0 +1,603 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/* Deterministic discrete-event simulation of a task graph on N virtual workers.
+ *
+ * The model follows the structure of `PoolScheduler` and `WorkerPool`:
+ * every worker owns a queue of ready tasks, a ready task is put into the queue
+ * chosen by the placement policy and the owner of that queue is woken up.
+ * A worker which runs out of tasks asks the steal policy for a victim
+ * and otherwise goes to sleep until a task is put into its own queue.
+ * The priority policy decides which task of a queue is taken next.
+ *
+ * No threads are involved and ties are broken by the order of events,
+ * so the result only depends on the graph, the policies and the configuration.
+ */
+
+#pragma once
+
+#include "task_graph.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace sim
+{
+
+    struct Config
+    {
+        unsigned workers = 1;
+
+        //! runtime cost added to the execution of every task
+        uint64_t overhead_ns = 0;
+
+        //! additional delay before a stolen task starts
+        uint64_t steal_ns = 0;
+
+        //! like REDGRAPES_EMPLACE_NOTIFY_NEXT: also wake an idle worker, which may steal the new task
+        bool notify_idle = false;
+    };
+
+    //! what the simulator knows at the time a decision is taken
+    struct State
+    {
+        TaskGraph const& graph;
+        Config const& config;
+
+        //! see `TaskGraph::bottom_levels()`
+        std::vector<uint64_t> const& bottom_level;
+
+        std::vector<std::deque<size_t>> queues;
+        std::vector<bool> busy;
+
+        //! worker which executed each task, if it was started already
+        std::vector<std::optional<unsigned>> executed_by;
+    };
+
+    /* chooses the queue a ready task is put into
+     */
+    struct PlacementPolicy
+    {
+        virtual ~PlacementPolicy() = default;
+        virtual std::string name() const = 0;
+
+        /*!
+         * @param task index of the task which became ready
+         * @param waker worker which completed the last dependency of `task`,
+         *        none if the task was ready when it was released
+         */
+        virtual unsigned place(State const& state, size_t task, std::optional<unsigned> waker) = 0;
+    };
+
+    /* chooses a worker to steal from for an idle worker
+     */
+    struct StealPolicy
+    {
+        virtual ~StealPolicy() = default;
+        virtual std::string name() const = 0;
+        virtual std::optional<unsigned> victim(State const& state, unsigned thief) = 0;
+    };
+
+    /* chooses the next task from a queue
+     */
+    struct PriorityPolicy
+    {
+        virtual ~PriorityPolicy() = default;
+        virtual std::string name() const = 0;
+
+        //! @return position in `queue` of the task the owner runs next
+        virtual size_t pick_own(State const& state, std::deque<size_t> const& queue) = 0;
+
+        //! @return position in `queue` of the task a thief takes
+        virtual size_t pick_steal(State const& state, std::deque<size_t> const& queue)
+        {
+            return pick_own(state, queue);
+        }
+    };
+
+    namespace policy
+    {
+        //! round-robin over all workers, like `PoolScheduler::getNextWorkerID()`
+        struct RoundRobin : PlacementPolicy
+        {
+            unsigned next = 0;
+
+            std::string name() const override
+            {
+                return "round_robin";
+            }
+
+            unsigned place(State const& state, size_t, std::optional<unsigned>) override
+            {
+                return next++ % state.config.workers;
+            }
+        };
+
+        /* the first idle worker after the waker, or round-robin if all are busy,
+         * like `WorkerPool::find_free_worker()` in `PoolScheduler::activate_task()`
+         */
+        struct FirstFree : PlacementPolicy
+        {
+            RoundRobin fallback;
+
+            std::string name() const override
+            {
+                return "first_free";
+            }
+
+            unsigned place(State const& state, size_t task, std::optional<unsigned> waker) override
+            {
+                unsigned const n = state.config.workers;
+                unsigned const start = waker.value_or(0);
+                for(unsigned k = 0; k < n; ++k)
+                {
+                    unsigned const w = (start + k) % n;
+                    if(!state.busy[w])
+                        return w;
+                }
+                return fallback.place(state, task, waker);
+            }
+        };
+
+        /* what the runtime does: newly released tasks go round-robin into the emplacement queues,
+         * tasks activated by a finished dependency go to the first free worker
+         */
+        struct Runtime : PlacementPolicy
+        {
+            RoundRobin emplace;
+            FirstFree activate;
+
+            std::string name() const override
+            {
+                return "runtime";
+            }
+
+            unsigned place(State const& state, size_t task, std::optional<unsigned> waker) override
+            {
+                return waker ? activate.place(state, task, waker) : emplace.place(state, task, waker);
+            }
+        };
+
+        //! the worker which completed the last dependency, so its outputs are still in cache
+        struct Locality : PlacementPolicy
+        {
+            RoundRobin fallback;
+
+            std::string name() const override
+            {
+                return "locality";
+            }
+
+            unsigned place(State const& state, size_t task, std::optional<unsigned> waker) override
+            {
+                return waker ? *waker : fallback.place(state, task, waker);
+            }
+        };
+
+        struct NoSteal : StealPolicy
+        {
+            std::string name() const override
+            {
+                return "none";
+            }
+
+            std::optional<unsigned> victim(State const&, unsigned) override
+            {
+                return std::nullopt;
+            }
+        };
+
+        //! probe the following workers in order, like `WorkerPool::steal_ready_task()`
+        struct NextBusy : StealPolicy
+        {
+            std::string name() const override
+            {
+                return "next_busy";
+            }
+
+            std::optional<unsigned> victim(State const& state, unsigned thief) override
+            {
+                unsigned const n = state.config.workers;
+                for(unsigned k = 1; k < n; ++k)
+                {
+                    unsigned const w = (thief + k) % n;
+                    if(!state.queues[w].empty())
+                        return w;
+                }
+                return std::nullopt;
+            }
+        };
+
+        //! a random worker with a non-empty queue, from a fixed seed
+        struct Random : StealPolicy
+        {
+            std::mt19937 gen;
+
+            Random(unsigned seed = 42) : gen(seed)
+            {
+            }
+
+            std::string name() const override
+            {
+                return "random";
+            }
+
+            std::optional<unsigned> victim(State const& state, unsigned thief) override
+            {
+                std::vector<unsigned> candidates;
+                for(unsigned w = 0; w < state.config.workers; ++w)
+                    if(w != thief && !state.queues[w].empty())
+                        candidates.push_back(w);
+                if(candidates.empty())
+                    return std::nullopt;
+                return candidates[std::uniform_int_distribution<size_t>(0, candidates.size() - 1)(gen)];
+            }
+        };
+
+        struct MostLoaded : StealPolicy
+        {
+            std::string name() const override
+            {
+                return "most_loaded";
+            }
+
+            std::optional<unsigned> victim(State const& state, unsigned thief) override
+            {
+                std::optional<unsigned> best;
+                for(unsigned w = 0; w < state.config.workers; ++w)
+                    if(w != thief && !state.queues[w].empty()
+                       && (!best || state.queues[w].size() > state.queues[*best].size()))
+                        best = w;
+                return best;
+            }
+        };
+
+        //! oldest task first, as in `task::Queue`
+        struct Fifo : PriorityPolicy
+        {
+            std::string name() const override
+            {
+                return "fifo";
+            }
+
+            size_t pick_own(State const&, std::deque<size_t> const&) override
+            {
+                return 0;
+            }
+        };
+
+        //! newest task first for the owner, oldest for thieves
+        struct Lifo : PriorityPolicy
+        {
+            std::string name() const override
+            {
+                return "lifo";
+            }
+
+            size_t pick_own(State const&, std::deque<size_t> const& queue) override
+            {
+                return queue.size() - 1;
+            }
+
+            size_t pick_steal(State const&, std::deque<size_t> const&) override
+            {
+                return 0;
+            }
+        };
+
+        //! longest remaining path first
+        struct CriticalPath : PriorityPolicy
+        {
+            std::string name() const override
+            {
+                return "critical_path";
+            }
+
+            size_t pick_own(State const& state, std::deque<size_t> const& queue) override
+            {
+                size_t best = 0;
+                for(size_t k = 1; k < queue.size(); ++k)
+                    if(state.bottom_level[queue[k]] > state.bottom_level[queue[best]])
+                        best = k;
+                return best;
+            }
+        };
+
+        inline std::unique_ptr<PlacementPolicy> make_placement(std::string const& name)
+        {
+            if(name == "runtime")
+                return std::make_unique<Runtime>();
+            if(name == "round_robin")
+                return std::make_unique<RoundRobin>();
+            if(name == "first_free")
+                return std::make_unique<FirstFree>();
+            if(name == "locality")
+                return std::make_unique<Locality>();
+            return nullptr;
+        }
+
+        inline std::unique_ptr<StealPolicy> make_steal(std::string const& name)
+        {
+            if(name == "none")
+                return std::make_unique<NoSteal>();
+            if(name == "next_busy")
+                return std::make_unique<NextBusy>();
+            if(name == "random")
+                return std::make_unique<Random>();
+            if(name == "most_loaded")
+                return std::make_unique<MostLoaded>();
+            return nullptr;
+        }
+
+        inline std::unique_ptr<PriorityPolicy> make_priority(std::string const& name)
+        {
+            if(name == "fifo")
+                return std::make_unique<Fifo>();
+            if(name == "lifo")
+                return std::make_unique<Lifo>();
+            if(name == "critical_path")
+                return std::make_unique<CriticalPath>();
+            return nullptr;
+        }
+    } // namespace policy
+
+    struct TaskResult
+    {
+        uint64_t ready = 0;
+        uint64_t start = 0;
+        uint64_t end = 0;
+        unsigned worker = 0;
+        bool stolen = false;
+
+        /*! how much the task could be delayed beyond its earliest start
+         *  without extending the critical path, with unlimited workers
+         */
+        uint64_t slack = 0;
+    };
+
+    struct Result
+    {
+        uint64_t makespan_ns = 0;
+        uint64_t work_ns = 0;
+
+        //! max(critical path, work / workers), no schedule can be shorter
+        uint64_t lower_bound_ns = 0;
+
+        uint64_t steals = 0;
+        std::vector<TaskResult> tasks;
+
+        double utilization(unsigned workers) const
+        {
+            return makespan_ns ? double(work_ns) / (double(workers) * makespan_ns) : 0.0;
+        }
+
+        double efficiency() const
+        {
+            return makespan_ns ? double(lower_bound_ns) / makespan_ns : 1.0;
+        }
+    };
+
+    class Simulator
+    {
+    public:
+        Simulator(
+            TaskGraph const& graph,
+            Config config,
+            PlacementPolicy& placement,
+            StealPolicy& steal,
+            PriorityPolicy& priority)
+            : graph(graph)
+            , config(config)
+            , placement(placement)
+            , steal(steal)
+            , priority(priority)
+            , bottom_level(graph.bottom_levels())
+            , state{graph, this->config, bottom_level, {}, {}, {}}
+        {
+        }
+
+        Result run()
+        {
+            size_t const n = graph.size();
+            unsigned const n_workers = std::max(1u, config.workers);
+            config.workers = n_workers;
+
+            state.queues.assign(n_workers, {});
+            state.busy.assign(n_workers, false);
+            state.executed_by.assign(n, std::nullopt);
+            running.assign(n_workers, 0);
+
+            result = Result{};
+            result.tasks.assign(n, {});
+            result.work_ns = graph.total_work_ns();
+
+            // a task waits for its release and all its dependencies
+            pending.assign(n, 1);
+            children.assign(n, 0);
+            child_list.assign(n, {});
+            finished.assign(n, false);
+            succs.assign(n, {});
+            for(size_t i = 0; i < n; ++i)
+            {
+                pending[i] += graph.preds[i].size();
+                for(size_t p : graph.preds[i])
+                    succs[p].push_back(i);
+                if(auto parent = graph.tasks[i].parent)
+                {
+                    children[*parent]++;
+                    child_list[*parent].push_back(i);
+                }
+                else
+                    push_event(graph.tasks[i].release_ns, Release, i);
+            }
+
+            while(!events.empty())
+            {
+                auto [time, seq, kind, idx] = events.top();
+                events.pop();
+                now = time;
+
+                if(kind == Release)
+                    satisfy(idx, std::nullopt);
+                else
+                    finish(unsigned(idx));
+            }
+
+            uint64_t const critical_path = graph.critical_path_ns();
+            std::vector<uint64_t> const earliest = graph.earliest_starts();
+            for(size_t i = 0; i < n; ++i)
+                result.tasks[i].slack = critical_path - (earliest[i] + bottom_level[i]);
+
+            result.lower_bound_ns = std::max(critical_path, result.work_ns / n_workers);
+            return result;
+        }
+
+    private:
+        enum EventKind
+        {
+            Release,
+            Finish
+        };
+
+        TaskGraph const& graph;
+        Config config;
+        PlacementPolicy& placement;
+        StealPolicy& steal;
+        PriorityPolicy& priority;
+        std::vector<uint64_t> bottom_level;
+        State state;
+
+        Result result;
+        uint64_t now = 0;
+
+        std::vector<size_t> pending;
+        //! number of children which did not complete yet
+        std::vector<size_t> children;
+        std::vector<std::vector<size_t>> child_list;
+        std::vector<bool> finished;
+        std::vector<std::vector<size_t>> succs;
+
+        //! task running on each worker
+        std::vector<size_t> running;
+
+        using Event = std::tuple<uint64_t, uint64_t, EventKind, size_t>;
+        std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+        uint64_t next_seq = 0;
+
+        void push_event(uint64_t time, EventKind kind, size_t idx)
+        {
+            events.emplace(time, next_seq++, kind, idx);
+        }
+
+        //! one of the conditions of `task` was met by `waker`
+        void satisfy(size_t task, std::optional<unsigned> waker)
+        {
+            if(--pending[task] > 0)
+                return;
+
+            result.tasks[task].ready = now;
+            unsigned const w = placement.place(state, task, waker) % config.workers;
+            state.queues[w].push_back(task);
+
+            if(!state.busy[w])
+                dispatch(w);
+            else if(config.notify_idle)
+                for(unsigned k = 1; k < config.workers; ++k)
+                {
+                    unsigned const other = (w + k) % config.workers;
+                    if(!state.busy[other])
+                    {
+                        dispatch(other);
+                        break;
+                    }
+                }
+        }
+
+        //! let an idle worker take a task from its own queue or steal one
+        void dispatch(unsigned w)
+        {
+            std::optional<size_t> task;
+            uint64_t delay = 0;
+            bool stolen = false;
+
+            if(!state.queues[w].empty())
+                task = take(state.queues[w], priority.pick_own(state, state.queues[w]));
+            else if(auto victim = steal.victim(state, w); victim && !state.queues[*victim].empty())
+            {
+                task = take(state.queues[*victim], priority.pick_steal(state, state.queues[*victim]));
+                delay = config.steal_ns;
+                stolen = true;
+                result.steals++;
+            }
+
+            if(!task)
+                return;
+
+            TaskGraph::Task const& t = graph.tasks[*task];
+            TaskResult& r = result.tasks[*task];
+            r.start = now + delay;
+            r.end = r.start + config.overhead_ns + t.duration_ns;
+            r.worker = w;
+            r.stolen = stolen;
+
+            state.busy[w] = true;
+            state.executed_by[*task] = w;
+            running[w] = *task;
+
+            // children are submitted while the parent runs
+            for(size_t c : child_list[*task])
+                push_event(r.start + std::min(graph.tasks[c].release_ns, t.duration_ns), Release, c);
+
+            push_event(r.end, Finish, w);
+        }
+
+        static size_t take(std::deque<size_t>& queue, size_t pos)
+        {
+            size_t const task = queue[pos];
+            queue.erase(queue.begin() + pos);
+            return task;
+        }
+
+        void finish(unsigned w)
+        {
+            size_t const task = running[w];
+            state.busy[w] = false;
+            finished[task] = true;
+            complete(task, w);
+
+            // the worker may already run a task activated by `complete()`
+            if(!state.busy[w])
+                dispatch(w);
+        }
+
+        //! the task and all its children are done
+        void complete(size_t task, unsigned w)
+        {
+            if(!finished[task] || children[task] > 0)
+                return;
+
+            result.makespan_ns = std::max(result.makespan_ns, now);
+            for(size_t s : succs[task])
+                satisfy(s, w);
+
+            if(auto parent = graph.tasks[task].parent)
+            {
+                children[*parent]--;
+                complete(*parent, w);
+            }
+        }
+    };
+
+} // namespace sim
@@ -0,0 +1,245 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/* Task graphs as recorded by `redGrapes::graph_recorder` (REDGRAPES_TASK_GRAPH=graph.json),
+ * reduced to what is needed to simulate or replay them:
+ * the measured duration, the submission time and the resource accesses of every task.
+ *
+ * The recorded dependency edges only contain waits which were actually inserted at runtime,
+ * so the full precedence relation is derived again from the resource accesses in submission order.
+ * Accesses other than `IOAccess` read are treated as writes, which is conservative
+ * for field and area accesses.
+ */
+
+#pragma once
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace sim
+{
+
+    struct TaskGraph
+    {
+        struct Access
+        {
+            unsigned resource;
+            bool write;
+        };
+
+        struct Task
+        {
+            uint64_t id;
+
+            //! index of the parent task in `tasks`
+            std::optional<size_t> parent;
+            std::string label;
+
+            //! measured execution time
+            uint64_t duration_ns = 0;
+
+            //! nanoseconds after the first submission, or after the start of the parent for child tasks
+            uint64_t release_ns = 0;
+
+            std::vector<Access> accesses;
+        };
+
+        //! in submission order
+        std::vector<Task> tasks;
+
+        //! indices of the direct predecessors of each task
+        std::vector<std::vector<size_t>> preds;
+
+        size_t size() const
+        {
+            return tasks.size();
+        }
+
+        uint64_t total_work_ns() const
+        {
+            uint64_t sum = 0;
+            for(Task const& t : tasks)
+                sum += t.duration_ns;
+            return sum;
+        }
+
+        //! derive `preds` from the resource accesses of sibling tasks, like the runtime does
+        void derive_dependencies()
+        {
+            preds.assign(tasks.size(), {});
+
+            // last writer and readers since then, per parent and resource
+            std::map<std::pair<std::optional<size_t>, unsigned>, std::pair<std::optional<size_t>, std::vector<size_t>>>
+                users;
+
+            for(size_t i = 0; i < tasks.size(); ++i)
+                for(Access const& a : tasks[i].accesses)
+                {
+                    auto& [writer, readers] = users[{tasks[i].parent, a.resource}];
+                    if(writer)
+                        preds[i].push_back(*writer);
+
+                    if(a.write)
+                    {
+                        preds[i].insert(preds[i].end(), readers.begin(), readers.end());
+                        writer = i;
+                        readers.clear();
+                    }
+                    else
+                        readers.push_back(i);
+                }
+
+            for(auto& p : preds)
+            {
+                std::sort(p.begin(), p.end());
+                p.erase(std::unique(p.begin(), p.end()), p.end());
+            }
+        }
+
+        /* length of the longest path from each task to the end of the graph, including the task itself.
+         * Children only start after their parent, so they extend the path of the parent.
+         */
+        std::vector<uint64_t> bottom_levels() const
+        {
+            std::vector<std::vector<size_t>> succs(tasks.size());
+            for(size_t i = 0; i < tasks.size(); ++i)
+            {
+                for(size_t p : preds[i])
+                    succs[p].push_back(i);
+                if(tasks[i].parent)
+                    succs[*tasks[i].parent].push_back(i);
+            }
+
+            // predecessors and parents always precede in submission order
+            std::vector<uint64_t> level(tasks.size());
+            for(size_t i = tasks.size(); i-- > 0;)
+            {
+                uint64_t longest = 0;
+                for(size_t s : succs[i])
+                    longest = std::max(longest, level[s]);
+                level[i] = tasks[i].duration_ns + longest;
+            }
+            return level;
+        }
+
+        //! earliest start of each task with an unlimited number of workers and no overhead
+        std::vector<uint64_t> earliest_starts() const
+        {
+            std::vector<uint64_t> start(tasks.size());
+            for(size_t i = 0; i < tasks.size(); ++i)
+            {
+                uint64_t t = tasks[i].release_ns;
+                if(tasks[i].parent)
+                    t += start[*tasks[i].parent];
+                for(size_t p : preds[i])
+                    t = std::max(t, start[p] + tasks[p].duration_ns);
+                start[i] = t;
+            }
+            return start;
+        }
+
+        //! makespan with an unlimited number of workers and no overhead
+        uint64_t critical_path_ns() const
+        {
+            std::vector<uint64_t> const start = earliest_starts();
+            std::vector<uint64_t> const level = bottom_levels();
+
+            uint64_t length = 0;
+            for(size_t i = 0; i < tasks.size(); ++i)
+                length = std::max(length, start[i] + level[i]);
+            return length;
+        }
+    };
+
+    /* load a task graph written by `graph_recorder::write_json()`
+     *
+     * @param keep_release if false, all top-level tasks are released at once instead of at their recorded
+     *        submission time, which removes the influence of the submitting thread
+     * @throws boost::property_tree::json_parser_error on malformed input
+     */
+    inline TaskGraph load(std::string const& path, bool keep_release = true)
+    {
+        namespace pt = boost::property_tree;
+
+        pt::ptree root;
+        pt::read_json(path, root);
+
+        struct Raw
+        {
+            TaskGraph::Task task;
+            std::optional<uint64_t> parent_id;
+            uint64_t submitted;
+            std::optional<uint64_t> start;
+        };
+
+        std::vector<Raw> raw;
+        for(auto const& [_, node] : root.get_child("tasks"))
+        {
+            Raw r;
+            r.task.id = node.get<uint64_t>("id");
+            r.task.label = node.get<std::string>("label", "");
+            r.submitted = node.get<uint64_t>("submitted");
+
+            if(auto parent = node.get_optional<uint64_t>("parent"))
+                r.parent_id = *parent;
+            if(auto start = node.get_optional<uint64_t>("start"))
+            {
+                r.start = *start;
+                r.task.duration_ns = node.get<uint64_t>("end") - *start;
+            }
+
+            for(auto const& [__, access] : node.get_child("resources"))
+            {
+                TaskGraph::Access a{access.get<unsigned>("resourceID"), true};
+                if(auto io = access.get_optional<std::string>("mode.IOAccess"))
+                    a.write = *io != "read";
+                r.task.accesses.push_back(a);
+            }
+
+            raw.push_back(std::move(r));
+        }
+
+        // task ids are handed out in submission order
+        std::sort(raw.begin(), raw.end(), [](Raw const& a, Raw const& b) { return a.task.id < b.task.id; });
+
+        std::map<uint64_t, size_t> index;
+        for(size_t i = 0; i < raw.size(); ++i)
+            index[raw[i].task.id] = i;
+
+        uint64_t first_submission = UINT64_MAX;
+        for(Raw const& r : raw)
+            if(!r.parent_id || !index.count(*r.parent_id))
+                first_submission = std::min(first_submission, r.submitted);
+
+        TaskGraph graph;
+        for(Raw& r : raw)
+        {
+            auto parent = r.parent_id ? index.find(*r.parent_id) : index.end();
+            if(parent != index.end())
+            {
+                r.task.parent = parent->second;
+                uint64_t const parent_start = raw[parent->second].start.value_or(r.submitted);
+                r.task.release_ns = r.submitted > parent_start ? r.submitted - parent_start : 0;
+            }
+            else if(keep_release)
+                r.task.release_ns = r.submitted - first_submission;
+
+            graph.tasks.push_back(std::move(r.task));
+        }
+
+        graph.derive_dependencies();
+        return graph;
+    }
+
+} // namespace sim
@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+# Copyright 2024 The RedGrapes Community
+#
+# This Source Code Form is subject to the terms of the Mozilla Public
+# License, v. 2.0. If a copy of the MPL was not distributed with this
+# file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+"""Strong and weak scaling sweeps of the application benchmarks (benchmarks/apps).
+
+Runs a `bench_<app>` driver once per worker count and placement and collects
+a scaling curve with parallel efficiency, the packages spanned by the workers
+and the scheduler counters (steals and probes of the worker-state bitfield).
+
+Strong scaling keeps the application parameters fixed. Weak scaling grows the
+parameter given by `--weak` with the number of workers, raised to `--exponent`,
+e.g. `--weak tiles --exponent 0.5` for the side length of a 2D grid, such that
+the work per worker stays constant.
+
+Efficiency is measured against the first worker count, scaled by the ratio of
+work, so it reads the same for both modes. Drops of the efficiency by more than
+`--cliff` between neighbouring worker counts are reported, and marked if the
+workers started to span another package at the same time.
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+
+
+def worker_counts(spec):
+    n_pus = os.cpu_count() or 1
+    if spec == "all":
+        return list(range(1, n_pus + 1))
+    if spec == "pow2":
+        counts, n = [], 1
+        while n < n_pus:
+            counts.append(n)
+            n *= 2
+        return counts + [n_pus]
+    return sorted({max(1, int(n)) for n in spec.split(",") if n})
+
+
+def run_driver(args, n, placement, params):
+    cmd = [
+        args.driver,
+        f"--workers={n}",
+        f"--repeat={args.repeat}",
+        f"--warmup={args.warmup}",
+        f"--placement={placement}",
+    ] + [f"{k}={v}" for k, v in params.items()]
+    print(" ".join(cmd), file=sys.stderr)
+    out = subprocess.run(cmd, check=True, stdout=subprocess.PIPE, text=True).stdout
+    return json.loads(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("driver", help="path to a bench_<app> executable")
+    parser.add_argument("params", nargs="*", help="application parameters as key=value")
+    parser.add_argument("--workers", default="pow2", help="comma separated worker counts, 'pow2' or 'all'")
+    parser.add_argument("--placement", default="compact,scatter", help="comma separated placements")
+    parser.add_argument("--weak", metavar="PARAM", help="parameter to scale with the workers for weak scaling")
+    parser.add_argument("--exponent", type=float, default=1.0, help="weak scaling: PARAM grows with workers^exponent")
+    parser.add_argument("--repeat", type=int, default=5)
+    parser.add_argument("--warmup", type=int, default=1)
+    parser.add_argument("--cliff", type=float, default=0.15, help="efficiency drop to report (default: 0.15)")
+    parser.add_argument("--json", help="write all results to this file")
+    args = parser.parse_intermixed_args()
+
+    params = dict(p.split("=", 1) for p in args.params)
+    if args.weak and args.weak not in params:
+        parser.error(f"--weak {args.weak} needs a base value, e.g. {args.weak}=8")
+
+    counts = worker_counts(args.workers)
+    sweep = {"mode": "weak" if args.weak else "strong", "curves": []}
+
+    for placement in args.placement.split(","):
+        points = []
+        for n in counts:
+            run_params = dict(params)
+            work = 1.0
+            if args.weak:
+                base = float(params[args.weak])
+                value = max(1, round(base * n**args.exponent))
+                run_params[args.weak] = value
+                work = (value / base) ** (1.0 / args.exponent)
+
+            result = run_driver(args, n, placement, run_params)
+            run = result["runs"][0]
+            stats = run["scheduler"]
+            points.append(
+                {
+                    "workers": n,
+                    "params": result["params"],
+                    "work": work,
+                    "median_s": run["median_s"],
+                    "mad_s": run["mad_s"],
+                    "tasks": run["tasks"],
+                    "utilization": run["utilization"],
+                    "overhead_ns_per_task": run["overhead_ns_per_task"],
+                    "pus": run["pus"],
+                    "packages": run["packages"],
+                    # counters are summed over the measured runs of the driver
+                    "scheduler": {k: v / args.repeat for k, v in stats.items()},
+                }
+            )
+
+        ref = points[0]
+        for p in points:
+            p["speedup"] = ref["median_s"] / p["median_s"] * (p["work"] / ref["work"])
+            p["efficiency"] = p["speedup"] * ref["workers"] / p["workers"]
+
+        cliffs = []
+        for prev, p in zip(points, points[1:]):
+            if prev["efficiency"] - p["efficiency"] > args.cliff:
+                cliffs.append(
+                    {
+                        "from": prev["workers"],
+                        "to": p["workers"],
+                        "efficiency_drop": prev["efficiency"] - p["efficiency"],
+                        "package_boundary": p["packages"] > prev["packages"],
+                    }
+                )
+
+        sweep["curves"].append({"app": result["app"], "placement": placement, "points": points, "cliffs": cliffs})
+
+    for curve in sweep["curves"]:
+        print(f"\n{curve['app']}, {sweep['mode']} scaling, {curve['placement']} placement")
+        print(
+            f"{'workers':>7} {'pkgs':>4} {'median [ms]':>12} {'speedup':>8} {'effic.':>7}"
+            f" {'steals/task':>11} {'probes/task':>11} {'conflicts':>9}"
+        )
+        for p in curve["points"]:
+            s = p["scheduler"]
+            tasks = max(1, p["tasks"])
+            steals = s["steal_ready_successes"] + s["steal_new_successes"]
+            print(
+                f"{p['workers']:>7} {p['packages']:>4} {p['median_s'] * 1e3:>12.3f} {p['speedup']:>8.2f}"
+                f" {p['efficiency']:>7.1%} {steals / tasks:>11.3f} {s['bitfield_probes'] / tasks:>11.3f}"
+                f" {s['claim_conflicts']:>9.0f}"
+            )
+        for c in curve["cliffs"]:
+            where = " at a package boundary" if c["package_boundary"] else ""
+            print(f"  efficiency drops by {c['efficiency_drop']:.1%} from {c['from']} to {c['to']} workers{where}")
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(sweep, f, indent=2)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,285 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/* Notify-to-run latency of sleeping threads and the CPU time burnt while idle,
+ * for a range of spin budgets (`CondVar::default_timeout`, see REDGRAPES_CONDVAR_TIMEOUT).
+ *
+ * Each sample first leaves the runtime idle for `gap_us`, so depending on the budget
+ * the woken thread is still polling or already asleep. Measured are
+ *
+ *   condvar  - `CondVar::notify()` until `wait()` returns in another thread
+ *   emplace  - `emplace_task()` until the task starts on a worker
+ *   activate - end of a task until its successor starts, which is made ready
+ *              through `PoolScheduler::activate_task()` on another worker
+ *   barrier  - end of the last task until `barrier()` returns in the main thread
+ *
+ * After that, the runtime is left idle for `idle_ms` and the CPU time consumed
+ * by the process is reported as the number of cores kept busy by idle workers.
+ *
+ * Command line: `--workers=2 --json=out.json timeouts=0,1024,... gaps_us=10,1000,20000 samples=50 idle_ms=200`
+ */
+
+#include "apps/driver.hpp"
+
+#include <redGrapes/resource/ioresource.hpp>
+#include <redGrapes/sync/cv.hpp>
+
+#include <sys/resource.h>
+
+#include <numeric>
+
+namespace
+{
+    using redGrapes::TscClock;
+
+    std::vector<unsigned long> parse_ulongs(std::string const& s)
+    {
+        std::vector<unsigned long> list;
+        std::istringstream in(s);
+        for(std::string item; std::getline(in, item, ',');)
+            if(!item.empty())
+                list.push_back(std::strtoul(item.c_str(), nullptr, 0));
+        return list;
+    }
+
+    //! user and system time of the whole process in seconds
+    double process_cpu_s()
+    {
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec
+               + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+    }
+
+    void busy_wait(std::chrono::microseconds duration)
+    {
+        auto const end = std::chrono::steady_clock::now() + duration;
+        while(std::chrono::steady_clock::now() < end)
+            ;
+    }
+
+    //! latencies of one mechanism at one gap, in nanoseconds
+    struct Series
+    {
+        std::string mechanism;
+        unsigned long gap_us;
+        std::vector<double> ns;
+
+        double percentile(double q) const
+        {
+            std::vector<double> v = ns;
+            std::sort(v.begin(), v.end());
+            return v.empty() ? 0.0 : v[std::min(v.size() - 1, size_t(q * v.size()))];
+        }
+
+        std::string to_json() const
+        {
+            double const mean = ns.empty() ? 0.0 : std::accumulate(ns.begin(), ns.end(), 0.0) / ns.size();
+            return fmt::format(
+                "{{\"mechanism\": \"{}\", \"gap_us\": {}, \"samples\": {}, \"mean_ns\": {:.0f}, \"p50_ns\": {:.0f}, "
+                "\"p90_ns\": {:.0f}, \"p99_ns\": {:.0f}, \"max_ns\": {:.0f}}}",
+                mechanism,
+                gap_us,
+                ns.size(),
+                mean,
+                percentile(0.5),
+                percentile(0.9),
+                percentile(0.99),
+                percentile(1.0));
+        }
+    };
+
+    Series condvar_latency(unsigned timeout, unsigned long gap_us, unsigned samples)
+    {
+        Series s{"condvar", gap_us, {}};
+        s.ns.reserve(samples);
+
+        redGrapes::CondVar cv(timeout);
+        std::atomic<uint64_t> sent{0};
+        std::atomic<unsigned> received{0};
+
+        std::thread waiter(
+            [&]
+            {
+                for(unsigned i = 0; i < samples; ++i)
+                {
+                    cv.wait();
+                    s.ns.push_back(TscClock::to_ns(TscClock::now() - sent.load()));
+                    received.store(i + 1, std::memory_order_release);
+                }
+            });
+
+        for(unsigned i = 0; i < samples; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(gap_us));
+            sent = TscClock::now();
+            cv.notify();
+            while(received.load(std::memory_order_acquire) <= i)
+                std::this_thread::yield();
+        }
+
+        waiter.join();
+        return s;
+    }
+
+    template<typename RG>
+    Series emplace_latency(RG& rg, unsigned long gap_us, unsigned samples)
+    {
+        Series s{"emplace", gap_us, {}};
+        for(unsigned i = 0; i < samples; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(gap_us));
+            uint64_t const sent = TscClock::now();
+            rg.emplace_task([&s, sent] { s.ns.push_back(TscClock::to_ns(TscClock::now() - sent)); });
+            rg.barrier();
+        }
+        return s;
+    }
+
+    template<typename RG>
+    Series activate_latency(RG& rg, unsigned long gap_us, unsigned samples)
+    {
+        Series s{"activate", gap_us, {}};
+        redGrapes::IOResource<uint64_t> finished;
+
+        for(unsigned i = 0; i < samples; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(gap_us));
+            rg.emplace_task(
+                [](auto finished)
+                {
+                    // long enough for the successor to be initialized and wait on this task
+                    busy_wait(std::chrono::microseconds(50));
+                    *finished = TscClock::now();
+                },
+                finished.write());
+            rg.emplace_task(
+                [&s](auto finished) { s.ns.push_back(TscClock::to_ns(TscClock::now() - *finished)); },
+                finished.write());
+            rg.barrier();
+        }
+        return s;
+    }
+
+    template<typename RG>
+    Series barrier_latency(RG& rg, unsigned long gap_us, unsigned samples)
+    {
+        Series s{"barrier", gap_us, {}};
+        for(unsigned i = 0; i < samples; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(gap_us));
+            std::atomic<uint64_t> finished{0};
+            rg.emplace_task(
+                [&finished]
+                {
+                    // long enough for the main thread to fall asleep
+                    busy_wait(std::chrono::microseconds(50));
+                    finished = TscClock::now();
+                });
+            rg.barrier();
+            s.ns.push_back(TscClock::to_ns(TscClock::now() - finished.load()));
+        }
+        return s;
+    }
+
+    //! average number of cores busy while the runtime has nothing to do
+    template<typename RG>
+    double idle_cores(RG& rg, unsigned idle_ms)
+    {
+        rg.emplace_task([] {});
+        rg.barrier();
+
+        double const cpu_begin = process_cpu_s();
+        auto const wall_begin = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(idle_ms));
+        double const cpu = process_cpu_s() - cpu_begin;
+        double const wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_begin).count();
+        return cpu / wall;
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    auto opt = bench::app::parse(argc, argv);
+    unsigned const n_workers = std::max(2u, *std::max_element(opt.workers.begin(), opt.workers.end()));
+    auto const timeouts = parse_ulongs(
+        opt.get<std::string>("timeouts", fmt::format("0,1024,16384,262144,{}", REDGRAPES_CONDVAR_TIMEOUT)));
+    auto const gaps = parse_ulongs(opt.get<std::string>("gaps_us", "10,1000,20000"));
+    unsigned const samples = std::max(1u, opt.get<unsigned>("samples", 50));
+    unsigned const idle_ms = opt.get<unsigned>("idle_ms", 200);
+
+    spdlog::set_default_logger(spdlog::stderr_color_st("wakeup_latency"));
+    spdlog::set_level(spdlog::level::warn);
+
+    std::string settings;
+    for(unsigned long timeout : timeouts)
+    {
+        std::vector<Series> series;
+        double idle;
+
+        for(unsigned long gap : gaps)
+            series.push_back(condvar_latency(timeout, gap, samples));
+
+        // the workers create their condition variables with the default budget
+        redGrapes::CondVar::default_timeout = timeout;
+        {
+            auto rg = redGrapes::init(n_workers);
+            for(unsigned long gap : gaps)
+            {
+                series.push_back(emplace_latency(rg, gap, samples));
+                series.push_back(activate_latency(rg, gap, samples));
+                series.push_back(barrier_latency(rg, gap, samples));
+            }
+            idle = idle_cores(rg, idle_ms);
+        }
+
+        fmt::print(stderr, "timeout {:>8}: idle cores {:.3f}\n", timeout, idle);
+        for(Series const& s : series)
+            fmt::print(
+                stderr,
+                "  {:<9} gap {:>6} us: p50 {:>9.0f} ns  p99 {:>9.0f} ns\n",
+                s.mechanism,
+                s.gap_us,
+                s.percentile(0.5),
+                s.percentile(0.99));
+
+        std::vector<std::string> latencies;
+        for(Series const& s : series)
+            latencies.push_back(s.to_json());
+        settings += fmt::format(
+            "{}\n    {{\"condvar_timeout\": {}, \"idle_cores\": {:.4f}, \"latency\": [\n      {}]}}",
+            settings.empty() ? "" : ",",
+            timeout,
+            idle,
+            fmt::join(latencies, ",\n      "));
+    }
+
+    std::string params;
+    for(auto const& [key, value] : opt.params)
+        params += fmt::format("{}\"{}\": \"{}\"", params.empty() ? "" : ", ", key, value);
+
+    std::string const json = fmt::format(
+        "{{\n  \"app\": \"wakeup_latency\",\n  \"params\": {{{}}},\n  \"hardware_concurrency\": {},\n"
+        "  \"workers\": {},\n  \"settings\": [{}\n  ]\n}}\n",
+        params,
+        std::thread::hardware_concurrency(),
+        n_workers,
+        settings);
+    std::cout << json;
+
+    if(!opt.json.empty())
+    {
+        std::ofstream file(opt.json);
+        file << json;
+        if(!file)
+        {
+            fmt::print(stderr, "could not write {}\n", opt.json);
+            return 1;
+        }
+    }
+    return 0;
+}
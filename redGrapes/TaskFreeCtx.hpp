@@ -7,11 +7,15 @@
 
 #pragma once
 
+#include "redGrapes/memory/chunk_cache.hpp"
 #include "redGrapes/memory/chunked_bump_alloc.hpp"
 #include "redGrapes/memory/hwloc_alloc.hpp"
+#include "redGrapes/memory/recycle_pool.hpp"
 #include "redGrapes/sync/cv.hpp"
+#include "redGrapes/util/placement.hpp"
 
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <optional>
 #include <vector>
@@ -29,17 +33,45 @@ namespace redGrapes
      */
     constexpr WorkerId parserID = -2;
 
+    //! allocator of each worker arena
+    using WorkerAlloc = memory::ChunkedBumpAlloc<memory::ChunkCache<memory::HwlocAlloc>>;
+
     // seperated to not templatize allocators with Task type
     struct WorkerAllocPool
     {
     public:
-        inline memory::ChunkedBumpAlloc<memory::HwlocAlloc>& get_alloc(WorkerId worker_id)
+        ~WorkerAllocPool()
+        {
+            // give recycled blocks back to their arena before it is destroyed
+            for(size_t worker_id = 0; worker_id < recycle_pools.size(); ++worker_id)
+                recycle_pools[worker_id].drain([&](memory::Block blk) { allocs[worker_id].deallocate(blk); });
+        }
+
+        inline WorkerAlloc& get_alloc(WorkerId worker_id)
         {
             assert(worker_id < allocs.size());
             return allocs[worker_id];
         }
 
-        std::vector<memory::ChunkedBumpAlloc<memory::HwlocAlloc>> allocs;
+        inline memory::RecyclePool& get_recycle_pool(WorkerId worker_id)
+        {
+            assert(worker_id < recycle_pools.size());
+            return recycle_pools[worker_id];
+        }
+
+        //! create the arena of the next worker, with memory bound to `obj`
+        inline void add_arena(HwlocContext& hwloc_ctx, hwloc_obj_t obj)
+        {
+            allocs.emplace_back(
+                memory::ChunkCache<memory::HwlocAlloc>(memory::HwlocAlloc(hwloc_ctx, obj)),
+                REDGRAPES_ALLOC_CHUNKSIZE);
+            recycle_pools.emplace_back();
+        }
+
+        std::vector<WorkerAlloc> allocs;
+
+        // deque since pools are not movable
+        std::deque<memory::RecyclePool> recycle_pools;
     };
 
     struct TaskFreeCtx
@@ -48,6 +80,20 @@ namespace redGrapes
         static inline WorkerId n_pus{
             static_cast<WorkerId>(hwloc_get_nbobjs_by_type(hwloc_ctx.topology, HWLOC_OBJ_PU))};
         static inline WorkerId n_workers;
+
+        //! placement of the workers created by the next call to `init()`
+        static inline Placement placement = placement_from_env();
+
+        //! PUs in the order of `placement`, computed by `init()`
+        static inline std::vector<hwloc_obj_t> pu_order;
+
+        //! processing unit the worker with `worker_id` is bound to
+        static inline hwloc_obj_t get_worker_pu(WorkerId worker_id)
+        {
+            assert(!pu_order.empty());
+            return pu_order[worker_id % pu_order.size()];
+        }
+
         static inline WorkerAllocPool worker_alloc_pool;
         static inline CondVar cv{0};
 
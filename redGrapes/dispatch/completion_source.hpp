@@ -0,0 +1,122 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <memory>
+#include <vector>
+
+namespace redGrapes
+{
+    namespace dispatch
+    {
+
+        /* A completion source tracks asynchronous operations which are
+         * handled outside of redGrapes (e.g. MPI requests, CUDA events,
+         * file I/O, timers) and notifies the corresponding events once
+         * these operations have finished.
+         *
+         * - `poll()` checks for finished operations, notifies their events
+         *   and returns the number of events that were reached.
+         * - `empty()` returns true if no operations are pending.
+         *
+         * If operations are registered from a thread other than the
+         * hosting worker, the source has to wake that worker afterwards,
+         * since it might be parked because all its sources were empty.
+         */
+        template<typename T>
+        concept C_CompletionSource = requires(T source) {
+            {
+                source.poll()
+            } -> std::convertible_to<unsigned>;
+            {
+                source.empty()
+            } -> std::convertible_to<bool>;
+        };
+
+        /* Type-erased set of completion sources which are polled by one worker.
+         *
+         * Sources can be added concurrently while the worker is polling:
+         * the list is copied on insertion and swapped in atomically,
+         * so `poll()` and `empty()` never need to take a lock.
+         */
+        struct CompletionSourceSet
+        {
+            template<C_CompletionSource Source>
+            void add(std::shared_ptr<Source> source)
+            {
+                std::shared_ptr<ISource> entry = std::make_shared<SourceModel<Source>>(std::move(source));
+
+                std::shared_ptr<SourceList const> old_list = sources.load();
+                std::shared_ptr<SourceList const> new_list;
+                do
+                {
+                    auto list = std::make_shared<SourceList>();
+                    if(old_list)
+                        *list = *old_list;
+                    list->push_back(entry);
+                    new_list = std::move(list);
+                } while(!sources.compare_exchange_weak(old_list, new_list));
+            }
+
+            //! @return total number of events reached in all sources
+            unsigned poll()
+            {
+                unsigned count = 0;
+                if(auto list = sources.load())
+                    for(auto const& source : *list)
+                        count += source->poll();
+                return count;
+            }
+
+            //! true if no source has pending operations
+            bool empty()
+            {
+                if(auto list = sources.load())
+                    for(auto const& source : *list)
+                        if(!source->empty())
+                            return false;
+                return true;
+            }
+
+        private:
+            struct ISource
+            {
+                virtual ~ISource() = default;
+                virtual unsigned poll() = 0;
+                virtual bool empty() = 0;
+            };
+
+            template<C_CompletionSource Source>
+            struct SourceModel : ISource
+            {
+                std::shared_ptr<Source> source;
+
+                SourceModel(std::shared_ptr<Source> source) : source(std::move(source))
+                {
+                }
+
+                unsigned poll() override
+                {
+                    return source->poll();
+                }
+
+                bool empty() override
+                {
+                    return source->empty();
+                }
+            };
+
+            using SourceList = std::vector<std::shared_ptr<ISource>>;
+
+            std::atomic<std::shared_ptr<SourceList const>> sources;
+        };
+
+    } // namespace dispatch
+} // namespace redGrapes
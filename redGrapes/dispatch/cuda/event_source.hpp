@@ -0,0 +1,81 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "redGrapes/dispatch/cuda/event_pool.hpp"
+#include "redGrapes/scheduler/event.hpp"
+
+#include <cuda.h>
+#include <spdlog/spdlog.h>
+
+#include <mutex>
+#include <queue>
+
+namespace redGrapes::dispatch::cuda
+{
+    /* Completion source for work submitted to cuda streams.
+     * Records a cuda event after each submission and notifies
+     * the associated redGrapes event once the cuda event is reached.
+     */
+    template<typename TTask>
+    struct CudaEventSource
+    {
+        EventPool event_pool;
+
+        std::queue<std::pair<cudaEvent_t, scheduler::EventPtr<TTask>>> events;
+        std::recursive_mutex mutex;
+
+        //! record a cuda event on `stream` which will notify `event` when reached
+        void record(cudaStream_t stream, scheduler::EventPtr<TTask> event)
+        {
+            std::lock_guard<std::recursive_mutex> lock(mutex);
+
+            cudaEvent_t cuda_event = event_pool.alloc();
+            cudaEventRecord(cuda_event, stream);
+            events.push(std::make_pair(cuda_event, event));
+
+            SPDLOG_TRACE("CudaEventSource: recorded event {} on stream {}", cuda_event, stream);
+        }
+
+        //! true if all recorded cuda events finished
+        bool empty()
+        {
+            std::lock_guard<std::recursive_mutex> lock(mutex);
+            return events.empty();
+        }
+
+        /*! checks if some cuda calls finished and notify the redGrapes manager
+         * @return number of finished cuda events
+         */
+        unsigned poll()
+        {
+            std::lock_guard<std::recursive_mutex> lock(mutex);
+            unsigned n_finished = 0;
+
+            // notify in recording order, so stop at the first unfinished one
+            while(!events.empty())
+            {
+                auto& cuda_event = events.front().first;
+                auto& event = events.front().second;
+
+                if(cudaEventQuery(cuda_event) != cudaSuccess)
+                    break;
+
+                SPDLOG_TRACE("cuda event {} ready", cuda_event);
+                event_pool.free(cuda_event);
+                event.notify();
+
+                events.pop();
+                ++n_finished;
+            }
+
+            return n_finished;
+        }
+    };
+
+} // namespace redGrapes::dispatch::cuda
@@ -52,23 +52,36 @@ namespace redGrapes
                     cuplaStreamDestroy(cupla_stream);
                 }
 
-                void poll()
+                //! true if all recorded cupla events finished
+                bool empty()
                 {
                     std::lock_guard<std::recursive_mutex> lock(mutex);
-                    if(!events.empty())
+                    return events.empty();
+                }
+
+                /*! notifies the events of all finished cupla calls
+                 * @return number of finished cupla events
+                 */
+                unsigned poll()
+                {
+                    std::lock_guard<std::recursive_mutex> lock(mutex);
+                    unsigned n_finished = 0;
+                    while(!events.empty())
                     {
                         auto& cupla_event = events.front().first;
                         auto& event = events.front().second;
 
-                        if(cuplaEventQuery(cupla_event) == cuplaSuccess)
-                        {
-                            SPDLOG_TRACE("cupla event {} ready", cupla_event);
-                            EventPool::get().free(cupla_event);
-                            event.notify();
+                        if(cuplaEventQuery(cupla_event) != cuplaSuccess)
+                            break;
 
-                            events.pop();
-                        }
+                        SPDLOG_TRACE("cupla event {} ready", cupla_event);
+                        EventPool::get().free(cupla_event);
+                        event.notify();
+
+                        events.pop();
+                        ++n_finished;
                     }
+                    return n_finished;
                 }
 
                 void dispatch_task(Task& task)
@@ -151,10 +164,21 @@ namespace redGrapes
                 }
 
                 //! checks if some cupla calls finished and notify the redGrapes manager
-                void poll()
+                unsigned poll()
+                {
+                    unsigned n_finished = 0;
+                    for(size_t stream_id = 0; stream_id < streams.size(); ++stream_id)
+                        n_finished += streams[stream_id].poll();
+                    return n_finished;
+                }
+
+                //! true if no cupla calls are pending on any stream
+                bool empty()
                 {
                     for(size_t stream_id = 0; stream_id < streams.size(); ++stream_id)
-                        streams[stream_id].poll();
+                        if(!streams[stream_id].empty())
+                            return false;
+                    return true;
                 }
 
                 /*! whats the task dependency type for the edge a -> b (task a precedes task b)
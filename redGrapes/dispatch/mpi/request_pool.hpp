@@ -7,11 +7,13 @@
 
 #pragma once
 
+#include "redGrapes/TaskFreeCtx.hpp"
 #include "redGrapes/globalSpace.hpp"
 #include "redGrapes/scheduler/event.hpp"
 
 #include <mpi.h>
 
+#include <cassert>
 #include <memory>
 #include <mutex>
 
@@ -27,25 +29,37 @@ namespace redGrapes
             {
                 std::mutex mutex;
 
+                //! the worker which polls this pool
+                WorkerId worker_id;
+
                 std::vector<MPI_Request> requests;
                 std::vector<scheduler::EventPtr<TTask>> events;
                 std::vector<std::shared_ptr<MPI_Status>> statuses;
 
-                RequestPool()
+                RequestPool(WorkerId worker_id) : worker_id(worker_id)
                 {
                 }
 
+                //! true if there are no active MPI requests to poll for
+                bool empty()
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    return requests.empty();
+                }
+
                 /*!
                  * Tests all currently active MPI requests
                  * and notifies the corresponding events if the requests finished
+                 *
+                 * @return number of finished requests
                  */
-                void poll()
+                unsigned poll()
                 {
                     std::lock_guard<std::mutex> lock(mutex);
 
+                    int outcount = 0;
                     if(!requests.empty())
                     {
-                        int outcount;
                         std::vector<int> indices(requests.size());
                         std::vector<MPI_Status> out_statuses(requests.size());
 
@@ -70,6 +84,8 @@ namespace redGrapes
                                     indices[j]--;
                         }
                     }
+
+                    return outcount > 0 ? outcount : 0;
                 }
 
                 /*!
@@ -77,12 +93,19 @@ namespace redGrapes
                  * yields until the request is done. While waiting
                  * for this request, other tasks will be executed.
                  *
-                 * Must be called inside a running task
+                 * Must be called inside a running task on the worker which
+                 * polls this pool. That worker picks up the request right
+                 * after the task yields, so it needs no wake-up.
+                 * Called from any other worker, the polling worker might be
+                 * asleep and never see the request.
+                 *
                  * @param request The MPI request to wait for
                  * @return the resulting MPI status of the request
                  */
                 MPI_Status get_status(MPI_Request request)
                 {
+                    assert(TaskFreeCtx::current_worker_id == worker_id);
+
                     auto status = memory::alloc_shared_bind<MPI_Status>(static_cast<TTask*>(current_task)->worker_id);
                     auto event = *create_event_impl<TTask>();
 
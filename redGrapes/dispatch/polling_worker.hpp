@@ -0,0 +1,249 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "redGrapes/TaskFreeCtx.hpp"
+#include "redGrapes/dispatch/completion_source.hpp"
+#include "redGrapes/globalSpace.hpp"
+#include "redGrapes/scheduler/scheduler_stats.hpp"
+#include "redGrapes/sync/backoff.hpp"
+#include "redGrapes/sync/cv.hpp"
+#include "redGrapes/task/queue.hpp"
+#include "redGrapes/util/graph_recorder.hpp"
+#include "redGrapes/util/perf_counters.hpp"
+#include "redGrapes/util/trace.hpp"
+#include "redGrapes/util/tracer.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+
+namespace redGrapes
+{
+    namespace dispatch
+    {
+
+        /* Worker which interleaves the execution of its tasks with polling
+         * a set of completion sources (see `C_CompletionSource`).
+         *
+         * Workers for asynchronous backends derive from this class (CRTP) and
+         * register their sources with `add_completion_source()`.
+         * `Derived` may shadow `execute_task()` to customize how a task is run.
+         *
+         * @tparam TTask task type
+         * @tparam Derived the concrete worker type
+         */
+        template<typename TTask, typename Derived>
+        struct PollingWorker
+        {
+            using task_type = TTask;
+
+            //! condition variable for waiting if queues are empty and no source is pending
+            CondVar cv;
+
+            WorkerId id;
+
+            /*! if true, the thread shall stop
+             * instead of waiting when it is out of jobs
+             */
+            std::atomic_bool m_stop{false};
+            std::atomic<unsigned> task_count{0};
+
+            static constexpr size_t queue_capacity = 128;
+            task::Queue<TTask> emplacement_queue{queue_capacity};
+            task::Queue<TTask> ready_queue{queue_capacity};
+
+            CompletionSourceSet completion_sources;
+
+            scheduler::WorkerCounters counters;
+
+            PollingWorker(WorkerId worker_id) : id(worker_id)
+            {
+            }
+
+            /* registers a new completion source which will be polled by this worker.
+             * may be called while the worker is running.
+             */
+            template<C_CompletionSource Source>
+            void add_completion_source(std::shared_ptr<Source> source)
+            {
+                completion_sources.add(std::move(source));
+                wake();
+            }
+
+            inline bool wake()
+            {
+                if(!cv.notify())
+                    return false;
+
+                counters.on_wakeup();
+                return true;
+            }
+
+            void stop()
+            {
+                SPDLOG_TRACE("Worker::stop()");
+                m_stop.store(true, std::memory_order_release);
+                wake();
+            }
+
+            /* adds a new task to the emplacement queue
+             * and wakes up thread to kickstart execution
+             */
+            inline void dispatch_task(TTask& task)
+            {
+                emplacement_queue.push(&task);
+                wake();
+            }
+
+            inline void execute_task(TTask& task)
+            {
+                TRACE_EVENT("Worker", "dispatch task");
+
+                SPDLOG_DEBUG("thread dispatch: execute task {}", task.task_id);
+                assert(task.is_ready());
+
+                task.get_pre_event().notify();
+                current_task = &task;
+
+                auto event = task();
+
+                if(event)
+                {
+                    event->get_event().waker_id = id;
+                    task.sg_pause(*event);
+
+                    task.pre_event.up();
+                    task.get_pre_event().notify();
+                }
+                else
+                    task.get_post_event().notify();
+
+                current_task = nullptr;
+            }
+
+            /* find a task that shall be executed next
+             */
+            TTask* gather_task()
+            {
+                {
+                    TRACE_EVENT("Worker", "gather_task()");
+                    TTask* task = nullptr;
+
+                    /* STAGE 1:
+                     *
+                     * first, execute all tasks in the ready queue
+                     */
+                    SPDLOG_TRACE("Worker {}: consume ready queue", id);
+                    if((task = ready_queue.pop()))
+                    {
+                        counters.on_ready_pop();
+                        return task;
+                    }
+
+                    /* STAGE 2:
+                     *
+                     * after the ready queue is fully consumed,
+                     * try initializing new tasks until one
+                     * of them is found to be ready
+                     */
+                    SPDLOG_TRACE("Worker {}: try init new tasks", id);
+                    while(this->init_dependencies(task, true))
+                        if(task)
+                            return task;
+
+                    return task;
+                }
+            }
+
+            /*! take a task from the emplacement queue and initialize it,
+             * @param t is set to the task if the new task is ready,
+             * @param t is set to nullptr if the new task is blocked.
+             * @param claimed if set, the new task will not be actiated,
+             *        if it is false, activate_task will be called by notify_event
+             *
+             * @return false if queue is empty
+             */
+            bool init_dependencies(TTask*& t, bool claimed = true)
+            {
+                {
+                    TRACE_EVENT("Worker", "init_dependencies()");
+                    if(TTask* task = emplacement_queue.pop())
+                    {
+                        SPDLOG_DEBUG("init task {}", task->task_id);
+                        counters.on_emplacement_pop();
+                        counters.on_initialize();
+
+                        task->pre_event.up();
+                        task->init_graph();
+
+                        if(task->get_pre_event().notify(claimed))
+                            t = task;
+                        else
+                        {
+                            t = nullptr;
+                        }
+
+                        return true;
+                    }
+                    else
+                        return false;
+                }
+            }
+
+            /* repeatedly try to find and execute tasks
+             * until stop-flag is triggered by stop().
+             *
+             * Completion sources are polled after every task.
+             * While some source has pending operations, the worker
+             * polls with adaptive backoff. Only if all sources are
+             * empty, the worker parks until it gets new tasks.
+             */
+            void work_loop()
+            {
+                SPDLOG_TRACE("Worker {} start work_loop()", this->id);
+                PollBackoff backoff;
+                while(!this->m_stop.load(std::memory_order_consume))
+                {
+                    while(TTask* task = this->gather_task())
+                    {
+                        // the task might be freed during execute_task()
+                        auto task_id = task->task_id;
+                        tracer::record(tracer::Kind::TaskStart, task_id);
+                        uint64_t const span_begin = graph_recorder::begin_span();
+                        counters.on_execute();
+                        perf_counters::Sample const perf_sample = perf_counters::begin_task();
+                        std::string const perf_label = perf_sample.active ? perf_counters::label_of(*task) : "";
+                        static_cast<Derived&>(*this).execute_task(*task);
+                        perf_counters::end_task(perf_sample, perf_label);
+                        graph_recorder::end_span(task_id, span_begin, this->id);
+                        tracer::record(tracer::Kind::TaskEnd, task_id);
+
+                        completion_sources.poll();
+                        backoff.reset();
+                    }
+
+                    if(completion_sources.poll() > 0)
+                        backoff.reset();
+                    else if(completion_sources.empty())
+                    {
+                        tracer::record(tracer::Kind::Sleep);
+                        counters.on_wait(this->cv.wait());
+                        tracer::record(tracer::Kind::Wake);
+                    }
+                    else
+                        backoff.pause(this->cv);
+                }
+                SPDLOG_TRACE("Worker {} end work_loop()", this->id);
+            }
+        };
+
+    } // namespace dispatch
+} // namespace redGrapes
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include "redGrapes/scheduler/scheduler_stats.hpp"
 #include "redGrapes/sync/cv.hpp"
 #include "redGrapes/task/queue.hpp"
 
@@ -49,6 +50,8 @@ namespace redGrapes
                 //! condition variable for waiting if queue is empty
                 CondVar cv;
 
+                scheduler::WorkerCounters counters;
+
                 static constexpr size_t queue_capacity = 128;
 
             public:
@@ -63,7 +66,11 @@ namespace redGrapes
 
                 inline bool wake()
                 {
-                    return cv.notify();
+                    if(!cv.notify())
+                        return false;
+
+                    counters.on_wakeup();
+                    return true;
                 }
 
                 void stop();
@@ -9,7 +9,10 @@
 #include "redGrapes/dispatch/thread/DefaultWorker.hpp"
 #include "redGrapes/dispatch/thread/worker_pool.hpp"
 #include "redGrapes/globalSpace.hpp"
+#include "redGrapes/util/graph_recorder.hpp"
+#include "redGrapes/util/perf_counters.hpp"
 #include "redGrapes/util/trace.hpp"
+#include "redGrapes/util/tracer.hpp"
 
 #include <hwloc.h>
 
@@ -37,7 +40,9 @@ namespace redGrapes
                 while(!m_stop.load(std::memory_order_consume))
                 {
                     worker_pool_p->set_worker_state_global(id, dispatch::thread::WorkerState::AVAILABLE);
-                    cv.wait();
+                    tracer::record(tracer::Kind::Sleep);
+                    counters.on_wait(cv.wait());
+                    tracer::record(tracer::Kind::Wake);
 
                     while(TTask* task = this->gather_task())
                     {
@@ -58,8 +63,16 @@ namespace redGrapes
 
                 task.get_pre_event().notify();
                 current_task = &task;
+                counters.on_execute();
 
+                tracer::record(tracer::Kind::TaskStart, task.task_id);
+                uint64_t const span_begin = graph_recorder::begin_span();
+                perf_counters::Sample const perf_sample = perf_counters::begin_task();
                 auto event = task();
+                if(perf_sample.active)
+                    perf_counters::end_task(perf_sample, perf_counters::label_of(task));
+                graph_recorder::end_span(task.task_id, span_begin, id);
+                tracer::record(tracer::Kind::TaskEnd, task.task_id);
 
                 if(event)
                 {
@@ -87,7 +100,10 @@ namespace redGrapes
                  */
                 SPDLOG_TRACE("Worker {}: consume ready queue", id);
                 if((task = ready_queue.pop()))
+                {
+                    counters.on_ready_pop();
                     return task;
+                }
 
                 /* STAGE 2:
                  *
@@ -116,6 +132,8 @@ namespace redGrapes
                  */
                 SPDLOG_TRACE("Worker {}: try to steal tasks", id);
                 task = worker_pool_p->steal_task(*this);
+                if(task)
+                    tracer::record(tracer::Kind::Steal, task->task_id);
 
 #endif
 
@@ -129,6 +147,8 @@ namespace redGrapes
                 if(TTask* task = emplacement_queue.pop())
                 {
                     SPDLOG_DEBUG("init task {}", task->task_id);
+                    counters.on_emplacement_pop();
+                    counters.on_initialize();
 
                     task->pre_event.up();
                     task->init_graph();
@@ -9,6 +9,10 @@
 
 #include "redGrapes/TaskFreeCtx.hpp"
 #include "redGrapes/memory/hwloc_alloc.hpp"
+#include "redGrapes/scheduler/scheduler_stats.hpp"
+#include "redGrapes/util/tracer.hpp"
+
+#include <fmt/format.h>
 
 #include <optional>
 #include <thread>
@@ -56,13 +60,16 @@ namespace redGrapes::dispatch::thread
 
             /* initialize thread-local variables
              */
-            *TaskFreeCtx::current_worker_id = worker.id;
+            TaskFreeCtx::current_worker_id = worker.id;
+            scheduler::WorkerCounters::current = &worker.counters;
+            tracer::set_thread_name(fmt::format("worker {}", worker.id));
 
             /* execute tasks until stop()
              */
             worker.work_loop();
 
             TaskFreeCtx::current_worker_id = std::nullopt;
+            scheduler::WorkerCounters::current = nullptr;
 
             SPDLOG_TRACE("Worker Finished!");
         }
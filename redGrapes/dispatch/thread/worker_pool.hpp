@@ -107,6 +107,8 @@ namespace redGrapes
                     std::optional<TTask*> task = probe_worker_by_state<TTask*>(
                         [&worker, this](WorkerId idx) -> std::optional<TTask*>
                         {
+                            worker.counters.on_bitfield_probe();
+
                             // we have a candidate of a busy worker,
                             // now check its queue
                             if(TTask* t = get_worker_thread(idx).worker.emplacement_queue.pop())
@@ -138,6 +140,8 @@ namespace redGrapes
                     std::optional<TTask*> task = probe_worker_by_state<TTask*>(
                         [&worker, this](WorkerId idx) -> std::optional<TTask*>
                         {
+                            worker.counters.on_bitfield_probe();
+
                             // we have a candidate of a busy worker,
                             // now check its queue
                             if(TTask* t = get_worker_thread(idx).worker.ready_queue.pop())
@@ -167,14 +171,19 @@ namespace redGrapes
                 {
                     SPDLOG_DEBUG("steal task for worker (global id) {}", worker.id);
 
-                    if(TTask* task = steal_ready_task(worker))
+                    TTask* task = steal_ready_task(worker);
+                    worker.counters.on_steal_ready(task != nullptr);
+                    if(task)
                     {
                         set_worker_state_global(worker.id, dispatch::thread::WorkerState::BUSY);
                         return task;
                     }
 
-                    if(TTask* task = steal_new_task(worker))
+                    task = steal_new_task(worker);
+                    worker.counters.on_steal_new(task != nullptr);
+                    if(task)
                     {
+                        worker.counters.on_initialize();
                         task->pre_event.up();
                         task->init_graph();
 
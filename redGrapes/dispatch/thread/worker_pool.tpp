@@ -13,6 +13,7 @@
 #include "redGrapes/memory/allocator.hpp"
 #include "redGrapes/memory/chunked_bump_alloc.hpp"
 #include "redGrapes/memory/hwloc_alloc.hpp"
+#include "redGrapes/scheduler/scheduler_stats.hpp"
 #include "redGrapes/util/trace.hpp"
 
 namespace redGrapes
@@ -42,12 +43,9 @@ namespace redGrapes
                 SPDLOG_DEBUG("populate WorkerPool with {} workers", num_workers);
                 for(WorkerId worker_id = base_id; worker_id < base_id + num_workers; ++worker_id)
                 {
-                    WorkerId pu_id = worker_id % TaskFreeCtx::n_pus;
                     // allocate worker with id `i` on arena `i`,
-                    hwloc_obj_t obj = hwloc_get_obj_by_type(TaskFreeCtx::hwloc_ctx.topology, HWLOC_OBJ_PU, pu_id);
-                    TaskFreeCtx::worker_alloc_pool.allocs.emplace_back(
-                        memory::HwlocAlloc(TaskFreeCtx::hwloc_ctx, obj),
-                        REDGRAPES_ALLOC_CHUNKSIZE);
+                    hwloc_obj_t obj = TaskFreeCtx::get_worker_pu(worker_id);
+                    TaskFreeCtx::worker_alloc_pool.add_arena(TaskFreeCtx::hwloc_ctx, obj);
 
                     auto worker = memory::alloc_shared_bind<WorkerThread<Worker>>(worker_id, obj, worker_id, *this);
                     workers.emplace_back(worker);
@@ -83,18 +81,31 @@ namespace redGrapes
                    && *TaskFreeCtx::current_worker_id < m_base_id + num_workers)
                     start_idx = *TaskFreeCtx::current_worker_id - m_base_id;
 
+                // only searches on worker threads are counted
+                scheduler::WorkerCounters* counters = scheduler::WorkerCounters::current;
+
                 std::optional<WorkerId> idx = this->probe_worker_by_state<WorkerId>(
-                    [this](WorkerId idx) -> std::optional<WorkerId>
+                    [this, counters](WorkerId idx) -> std::optional<WorkerId>
                     {
+                        if(counters)
+                            counters->on_bitfield_probe();
+
                         if(set_worker_state(idx, WorkerState::BUSY))
                             return idx;
                         else
+                        {
+                            if(counters)
+                                counters->on_claim_conflict();
                             return std::nullopt;
+                        }
                     },
                     dispatch::thread::WorkerState::AVAILABLE, // find a free worker
                     start_idx,
                     false);
 
+                if(counters)
+                    counters->on_free_worker_search(idx.has_value());
+
                 if(idx)
                     return *idx;
                 else
@@ -0,0 +1,168 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+
+/* if enabled, every worker allocator maintains counters
+ * which can be read with `RedGrapes::memory_stats()`.
+ * Since any thread may allocate from a worker arena, the counters are
+ * updated with atomic read-modify-writes on every allocation,
+ * so they are disabled by default.
+ */
+#ifndef REDGRAPES_ALLOC_STATS
+#    define REDGRAPES_ALLOC_STATS 0
+#endif
+
+namespace redGrapes
+{
+    namespace memory
+    {
+
+        //! snapshot of the state of one worker allocator
+        struct AllocStats
+        {
+            //! bytes handed out and not yet freed (including remote frees which are not reclaimed yet)
+            size_t bytes_live = 0;
+
+            //! maximum of `bytes_live` since the allocator was created
+            size_t bytes_high_water = 0;
+
+            //! bytes lost by rounding requests up to their size class, accumulated over all allocations
+            size_t bytes_rounding_waste = 0;
+
+            //! bytes of freed blocks kept in free lists for reuse
+            size_t bytes_cached = 0;
+
+            //! number of chunks currently held by the allocator
+            size_t chunks_held = 0;
+
+            //! size of each chunk in bytes
+            size_t chunk_size = 0;
+
+            //! chunks which are exhausted but kept alive by a single remaining block
+            size_t chunks_pinned = 0;
+
+            //! empty chunks kept for reuse by the chunk allocator
+            size_t chunks_cached = 0;
+
+            //! number of blocks freed by threads other than the owning worker
+            size_t remote_frees = 0;
+
+            AllocStats& operator+=(AllocStats const& other)
+            {
+                bytes_live += other.bytes_live;
+                bytes_high_water += other.bytes_high_water;
+                bytes_rounding_waste += other.bytes_rounding_waste;
+                bytes_cached += other.bytes_cached;
+                chunks_held += other.chunks_held;
+                chunk_size = std::max(chunk_size, other.chunk_size);
+                chunks_pinned += other.chunks_pinned;
+                chunks_cached += other.chunks_cached;
+                remote_frees += other.remote_frees;
+                return *this;
+            }
+        };
+
+        /* counters maintained by each worker allocator.
+         * All updates are relaxed, so they are only
+         * approximate while other threads allocate.
+         */
+        struct AllocCounters
+        {
+#if REDGRAPES_ALLOC_STATS
+            std::atomic<size_t> bytes_live{0};
+            std::atomic<size_t> bytes_high_water{0};
+            std::atomic<size_t> bytes_rounding_waste{0};
+
+            //! written by threads which do not own the arena, so kept apart from the other counters
+            alignas(64) std::atomic<size_t> remote_frees{0};
+
+            inline void on_allocate(size_t requested, size_t allocated)
+            {
+                size_t live = bytes_live.fetch_add(allocated, std::memory_order_relaxed) + allocated;
+
+                size_t high_water = bytes_high_water.load(std::memory_order_relaxed);
+                while(live > high_water
+                      && !bytes_high_water.compare_exchange_weak(high_water, live, std::memory_order_relaxed))
+                    ;
+
+                if(allocated > requested)
+                    bytes_rounding_waste.fetch_add(allocated - requested, std::memory_order_relaxed);
+            }
+
+            inline void on_deallocate(size_t allocated)
+            {
+                bytes_live.fetch_sub(allocated, std::memory_order_relaxed);
+            }
+
+            inline void on_remote_free()
+            {
+                remote_frees.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            inline void read(AllocStats& stats) const
+            {
+                stats.bytes_live = bytes_live.load(std::memory_order_relaxed);
+                stats.bytes_high_water = bytes_high_water.load(std::memory_order_relaxed);
+                stats.bytes_rounding_waste = bytes_rounding_waste.load(std::memory_order_relaxed);
+                stats.remote_frees = remote_frees.load(std::memory_order_relaxed);
+            }
+#else
+            inline void on_allocate(size_t, size_t)
+            {
+            }
+
+            inline void on_deallocate(size_t)
+            {
+            }
+
+            inline void on_remote_free()
+            {
+            }
+
+            inline void read(AllocStats&) const
+            {
+            }
+#endif
+        };
+
+    } // namespace memory
+} // namespace redGrapes
+
+template<>
+struct fmt::formatter<redGrapes::memory::AllocStats>
+{
+    constexpr auto parse(format_parse_context& ctx)
+    {
+        return ctx.begin();
+    }
+
+    template<typename FormatContext>
+    auto format(redGrapes::memory::AllocStats const& s, FormatContext& ctx) const
+    {
+        return fmt::format_to(
+            ctx.out(),
+            "{{ \"bytes_live\" : {}, \"bytes_high_water\" : {}, \"bytes_rounding_waste\" : {}, "
+            "\"bytes_cached\" : {}, \"chunks_held\" : {}, \"chunk_size\" : {}, \"chunks_pinned\" : {}, "
+            "\"chunks_cached\" : {}, \"remote_frees\" : {} }}",
+            s.bytes_live,
+            s.bytes_high_water,
+            s.bytes_rounding_waste,
+            s.bytes_cached,
+            s.chunks_held,
+            s.chunk_size,
+            s.chunks_pinned,
+            s.chunks_cached,
+            s.remote_frees);
+    }
+};
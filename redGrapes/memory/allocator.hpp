@@ -38,9 +38,51 @@ namespace redGrapes
                 return TaskFreeCtx::worker_alloc_pool.get_alloc(worker_id).allocate(n_bytes);
             }
 
+            /* blocks freed from a thread other than the owning worker
+             * are handed back through its remote-free list
+             */
             void deallocate(Block blk)
             {
-                TaskFreeCtx::worker_alloc_pool.get_alloc(worker_id).deallocate(blk);
+                auto& alloc = TaskFreeCtx::worker_alloc_pool.get_alloc(worker_id);
+                if(TaskFreeCtx::current_worker_id == worker_id)
+                    alloc.deallocate(blk);
+                else
+                    alloc.deallocate_remote(blk);
+            }
+        };
+
+        /* allocator for objects which are created and destroyed at a high rate.
+         * Blocks freed by the owning worker are kept in its recycle pool
+         * and handed out again for objects of the same size.
+         * The pool is only used from the owning worker, other threads
+         * go through the arena and its remote-free list instead.
+         */
+        struct RecyclingAllocator
+        {
+            WorkerId worker_id;
+
+            RecyclingAllocator() : RecyclingAllocator(*TaskFreeCtx::current_worker_id)
+            {
+            }
+
+            RecyclingAllocator(WorkerId worker_id) : worker_id(worker_id)
+            {
+            }
+
+            Block allocate(size_t n_bytes)
+            {
+                if(TaskFreeCtx::current_worker_id == worker_id)
+                    if(Block blk = TaskFreeCtx::worker_alloc_pool.get_recycle_pool(worker_id).allocate(n_bytes))
+                        return blk;
+
+                return Allocator(worker_id).allocate(n_bytes);
+            }
+
+            void deallocate(Block blk)
+            {
+                if(TaskFreeCtx::current_worker_id != worker_id
+                   || !TaskFreeCtx::worker_alloc_pool.get_recycle_pool(worker_id).deallocate(blk))
+                    Allocator(worker_id).deallocate(blk);
             }
         };
 
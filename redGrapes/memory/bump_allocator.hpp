@@ -72,6 +72,12 @@ namespace redGrapes
                 return next_addr <= lower_limit;
             }
 
+            //! number of blocks allocated from this chunk which are not freed yet
+            uint16_t active_allocations() const
+            {
+                return count.load(std::memory_order_relaxed);
+            }
+
             /*! checks whether this block is managed by this allocator
              */
             bool owns(Block const& blk) const
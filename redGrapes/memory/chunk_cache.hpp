@@ -0,0 +1,279 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "redGrapes/memory/block.hpp"
+#include "redGrapes/sync/spinlock.hpp"
+#include "redGrapes/util/trace.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if defined(__linux__)
+#    include <sys/mman.h>
+#endif
+
+/* maximum number of empty chunks kept by each worker arena
+ * instead of returning them to the system
+ */
+#ifndef REDGRAPES_ALLOC_CHUNK_CACHE_LIMIT
+#    define REDGRAPES_ALLOC_CHUNK_CACHE_LIMIT 16
+#endif
+
+/* if enabled, worker arenas are backed by large regions
+ * which are aligned to huge pages and subdivided into chunks
+ */
+#ifndef REDGRAPES_ALLOC_HUGEPAGES
+#    define REDGRAPES_ALLOC_HUGEPAGES 0
+#endif
+
+/* size of the regions used with REDGRAPES_ALLOC_HUGEPAGES,
+ * must be a multiple of the huge page size
+ */
+#ifndef REDGRAPES_ALLOC_REGION_SIZE
+#    define REDGRAPES_ALLOC_REGION_SIZE (2 * 1024 * 1024)
+#endif
+
+namespace redGrapes
+{
+    namespace memory
+    {
+
+        /* Allocator adaptor which keeps empty chunks for reuse
+         * instead of handing each one back to the underlying allocator.
+         *
+         * Up to `limit` freed chunks are cached and returned by
+         * the next chunk allocation, which avoids a pair of
+         * map/unmap syscalls for every chunk when bursts of tasks drain.
+         *
+         * If `region_size` is nonzero, aligned chunks are carved out of
+         * regions of that size, which are aligned to `hugepage_size`
+         * and advised to be backed by transparent huge pages.
+         * Regions are only released when the cache is destroyed.
+         * Free chunks above the retention limit stay in the region,
+         * but their physical pages are given back to the system.
+         *
+         * Copies share the same cache, so it can be passed by value
+         * like any other allocator.
+         */
+        template<typename Alloc>
+        struct ChunkCache
+        {
+            static constexpr size_t hugepage_size = 2 * 1024 * 1024;
+
+            ChunkCache(
+                Alloc&& alloc,
+                size_t limit = REDGRAPES_ALLOC_CHUNK_CACHE_LIMIT,
+                size_t region_size = REDGRAPES_ALLOC_HUGEPAGES ? REDGRAPES_ALLOC_REGION_SIZE : 0)
+                : state(std::make_shared<State>(std::move(alloc), limit, region_size))
+            {
+                assert(region_size % hugepage_size == 0);
+            }
+
+            Block allocate(size_t n_bytes) noexcept
+            {
+                return state->allocate(n_bytes);
+            }
+
+            /* allocate a block which contains `n_bytes` aligned to `alignment`.
+             * The returned block has to be passed to `deallocate()` unchanged.
+             */
+            Block allocate_aligned(size_t n_bytes, size_t alignment) noexcept
+            {
+                if(state->region_size && n_bytes <= alignment && alignment <= state->region_size)
+                    if(Block blk = state->allocate_from_region(n_bytes, alignment))
+                        return blk;
+
+                state->chunk_len.store(n_bytes + alignment, std::memory_order_relaxed);
+                return state->allocate(n_bytes + alignment);
+            }
+
+            void deallocate(Block blk) noexcept
+            {
+                state->deallocate(blk);
+            }
+
+            //! number of empty chunks currently kept for reuse
+            size_t cached_chunks() const
+            {
+                std::lock_guard<SpinLock> lock(state->mutex);
+                return state->cached.size() + state->released.size();
+            }
+
+        private:
+            struct State
+            {
+                Alloc alloc;
+                size_t const limit;
+                size_t const region_size;
+
+                SpinLock mutex;
+
+                //! free blocks which are ready to be reused
+                std::vector<Block> cached;
+
+                //! free region chunks whose pages were given back to the system
+                std::vector<Block> released;
+
+                //! underlying allocations of all regions
+                std::vector<Block> regions;
+
+                //! next unused chunk in the current region
+                uintptr_t region_cur = 0;
+                uintptr_t region_end = 0;
+
+                //! distance between chunks carved from regions
+                size_t stride = 0;
+
+                //! length of the padded blocks used for chunks outside of regions
+                std::atomic<size_t> chunk_len{0};
+
+                State(Alloc&& alloc, size_t limit, size_t region_size)
+                    : alloc(std::move(alloc))
+                    , limit(limit)
+                    , region_size(region_size)
+                {
+                }
+
+                ~State()
+                {
+                    for(Block blk : cached)
+                        if(!in_region(blk))
+                            alloc.deallocate(blk);
+
+                    for(Block region : regions)
+                        alloc.deallocate(region);
+                }
+
+                Block allocate(size_t n_bytes) noexcept
+                {
+                    {
+                        std::lock_guard<SpinLock> lock(mutex);
+                        for(auto it = cached.rbegin(); it != cached.rend(); ++it)
+                            if(it->len == n_bytes && !in_region(*it))
+                            {
+                                Block blk = *it;
+                                cached.erase(std::next(it).base());
+                                return blk;
+                            }
+                    }
+
+                    return alloc.allocate(n_bytes);
+                }
+
+                Block allocate_from_region(size_t n_bytes, size_t alignment) noexcept
+                {
+                    std::lock_guard<SpinLock> lock(mutex);
+
+                    if(stride == 0)
+                        stride = alignment;
+                    else if(stride != alignment)
+                        return Block::null();
+
+                    Block blk = Block::null();
+                    if(pop_region_chunk(cached, blk) || pop_region_chunk(released, blk))
+                    {
+                        blk.len = n_bytes;
+                        return blk;
+                    }
+
+                    if(region_cur + stride > region_end && !allocate_region())
+                        return Block::null();
+
+                    blk = Block{region_cur, n_bytes};
+                    region_cur += stride;
+                    return blk;
+                }
+
+                void deallocate(Block blk) noexcept
+                {
+                    TRACE_EVENT("Allocator", "ChunkCache::deallocate()");
+                    std::unique_lock<SpinLock> lock(mutex);
+
+                    // only chunks are cached, other blocks (e.g. large objects) are returned directly
+                    bool const region_chunk = in_region(blk);
+                    if(region_chunk || blk.len == chunk_len.load(std::memory_order_relaxed))
+                    {
+                        if(cached.size() < limit)
+                        {
+                            cached.push_back(blk);
+                            return;
+                        }
+
+                        if(region_chunk)
+                        {
+                            // keep the address range, but drop its pages
+#if defined(__linux__)
+                            madvise((void*) blk.ptr, stride, MADV_DONTNEED);
+#endif
+                            released.push_back(blk);
+                            return;
+                        }
+                    }
+
+                    lock.unlock();
+                    alloc.deallocate(blk);
+                }
+
+            private:
+                bool in_region(Block blk) const
+                {
+                    for(Block region : regions)
+                        if(blk.ptr >= region.ptr && blk.ptr < region.ptr + region.len)
+                            return true;
+                    return false;
+                }
+
+                bool pop_region_chunk(std::vector<Block>& list, Block& blk)
+                {
+                    for(auto it = list.rbegin(); it != list.rend(); ++it)
+                        if(in_region(*it))
+                        {
+                            blk = *it;
+                            list.erase(std::next(it).base());
+                            return true;
+                        }
+                    return false;
+                }
+
+                bool allocate_region()
+                {
+                    TRACE_EVENT("Allocator", "ChunkCache::allocate_region()");
+
+                    // over-allocate so the region can be aligned to a huge page
+                    Block region = alloc.allocate(region_size + hugepage_size);
+                    if(!region)
+                        return false;
+
+                    regions.push_back(region);
+                    region_cur = (region.ptr + hugepage_size - 1) & ~(uintptr_t) (hugepage_size - 1);
+                    region_end = region_cur + region_size;
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+                    if(madvise((void*) region_cur, region_size, MADV_HUGEPAGE) != 0)
+                        SPDLOG_WARN("ChunkCache: madvise(MADV_HUGEPAGE) failed: {}", strerror(errno));
+#endif
+
+                    SPDLOG_TRACE("ChunkCache: new region {},{}", region_cur, region_size);
+                    return true;
+                }
+            };
+
+            std::shared_ptr<State> state;
+        };
+
+    } // namespace memory
+} // namespace redGrapes
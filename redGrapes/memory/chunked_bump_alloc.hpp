@@ -7,15 +7,23 @@
 
 #pragma once
 
+#include "redGrapes/memory/alloc_stats.hpp"
 #include "redGrapes/memory/bump_allocator.hpp"
+#include "redGrapes/memory/free_list.hpp"
 #include "redGrapes/memory/hwloc_alloc.hpp"
+#include "redGrapes/memory/size_class.hpp"
+#include "redGrapes/sync/spinlock.hpp"
 #include "redGrapes/util/atomic_list.hpp"
 #include "redGrapes/util/trace.hpp"
+#include "redGrapes/util/tracer.hpp"
 
 #include <boost/core/demangle.hpp>
 #include <spdlog/spdlog.h>
 
+#include <array>
+#include <atomic>
 #include <cstddef>
+#include <mutex>
 
 #if REDGRAPES_ENABLE_BACKWARDCPP
 #    include <backward.hpp>
@@ -26,14 +34,45 @@ namespace redGrapes
     namespace memory
     {
 
-/* use 64KiB as default chunksize
+/* use 64KiB as default chunksize,
+ * must be a power of two since chunks are aligned to it
  */
 #ifndef REDGRAPES_ALLOC_CHUNKSIZE
 #    define REDGRAPES_ALLOC_CHUNKSIZE (64 * 1024)
+#endif
+
+/* maximum number of freed blocks kept per size class for reuse,
+ * further blocks are returned to their chunk
+ */
+#ifndef REDGRAPES_ALLOC_FREELIST_LIMIT
+#    define REDGRAPES_ALLOC_FREELIST_LIMIT 256
 #endif
 
         struct HwlocAlloc;
 
+        /* Allocates memory blocks from a list of chunks via bump allocation.
+         *
+         * Requests up to `size_class::max_size` are rounded up to their size class.
+         * Freed blocks of these classes are kept in a free list per class and
+         * handed out again before the chunks are bumped any further,
+         * so a single long-lived allocation does not keep the
+         * remaining space of its chunk from being reused.
+         * Larger requests are rounded up to the next power of two and
+         * are returned to their chunk directly.
+         * Requests which do not fit into a chunk at all are served
+         * by the underlying allocator directly (large-object path).
+         *
+         * Chunks are aligned to `chunk_size` (a power of two), so the chunk
+         * owning a block is found by masking its address.
+         *
+         * Threads other than the owner of this arena should free blocks with
+         * `deallocate_remote()`, which only pushes the block on a lock-free list.
+         * These blocks are reclaimed in batches on allocation.
+         *
+         * `deallocate()` relies on the passed length not exceeding the length
+         * of the original request, since it determines the free list.
+         * Blocks of the large-object path must be freed with the exact requested length.
+         */
         template<typename Alloc = HwlocAlloc>
         struct ChunkedBumpAlloc
         {
@@ -43,14 +82,25 @@ namespace redGrapes
 
             ChunkedBumpAlloc(Alloc&& alloc, size_t chunk_size = REDGRAPES_ALLOC_CHUNKSIZE)
                 : chunk_size(chunk_size)
-                , bump_allocators(std::move(alloc), chunk_size)
+                , bump_allocators(
+                      std::move(alloc),
+                      chunk_size - AtomicList<BumpAllocator, Alloc>::get_controlblock_size(),
+                      chunk_size)
             {
             }
 
             ChunkedBumpAlloc(ChunkedBumpAlloc&& other)
                 : chunk_size(other.chunk_size)
                 , bump_allocators(other.bump_allocators)
+                , remote_frees(other.remote_frees.exchange(nullptr))
             {
+                for(size_t i = 0; i < size_class::count; ++i)
+                {
+                    std::lock_guard<SpinLock> lock(other.free_lists[i].mutex);
+                    free_lists[i].head = other.free_lists[i].head;
+                    free_lists[i].length = other.free_lists[i].length.exchange(0);
+                    other.free_lists[i].head = nullptr;
+                }
             }
 
             static inline size_t roundup_to_poweroftwo(size_t s)
@@ -66,14 +116,67 @@ namespace redGrapes
                 return s;
             }
 
+            //! number of bytes available for blocks in each chunk
+            size_t chunk_capacity() const
+            {
+                // the BumpAllocator object itself is placed at the front of the chunk
+                return bump_allocators.chunk_capacity - sizeof(BumpAllocator);
+            }
+
+            //! whether a request of `n` bytes bypasses the chunks
+            bool is_large(size_t n) const
+            {
+                return n > size_class::max_size && roundup_to_poweroftwo(n) > chunk_capacity();
+            }
+
+            //! number of bytes actually reserved for a request of `n` bytes
+            size_t allocation_size(size_t n) const
+            {
+                if(n <= size_class::max_size)
+                    return size_class::size(size_class::index(n));
+                else if(is_large(n))
+                    return n;
+                else
+                    return roundup_to_poweroftwo(n);
+            }
+
             Block allocate(std::size_t n = 1) noexcept
             {
                 TRACE_EVENT("Allocator", "ChunkedBumpAlloc::allocate()");
-                size_t alloc_size = roundup_to_poweroftwo(n);
 
-                size_t const chunk_capacity = bump_allocators.get_chunk_capacity();
+                Block blk = Block::null();
+                if(n <= size_class::max_size)
+                {
+                    size_t const idx = size_class::index(n);
+                    blk = free_lists[idx].pop(size_class::size(idx));
+                    if(!blk && reclaim_remote_frees() > 0)
+                        blk = free_lists[idx].pop(size_class::size(idx));
 
-                if(alloc_size <= chunk_capacity)
+                    if(blk)
+                        SPDLOG_TRACE("ChunkedBumpAlloc: reuse {},{}", blk.ptr, blk.len);
+                    else
+                        blk = allocate_from_chunk(size_class::size(idx));
+                }
+                else if(is_large(n))
+                {
+                    reclaim_remote_frees();
+                    blk = allocate_large(n);
+                }
+                else
+                {
+                    reclaim_remote_frees();
+                    blk = allocate_from_chunk(roundup_to_poweroftwo(n));
+                }
+
+                if(blk)
+                    counters.on_allocate(n, blk.len);
+
+                return blk;
+            }
+
+            Block allocate_from_chunk(size_t alloc_size) noexcept
+            {
+                if(alloc_size <= chunk_capacity())
                 {
                     Block blk = Block::null();
 
@@ -88,11 +191,26 @@ namespace redGrapes
 
                             // chunk is full, create a new one
                             if(!blk)
+                            {
+                                tracer::record(tracer::Kind::Allocate, chunk_size);
                                 bump_allocators.allocate_item();
+
+                                /* a chunk which was drained before it became full
+                                 * is not erased by `deallocate_to_chunk()`,
+                                 * so erase it here once it is no longer head
+                                 */
+                                if(chunk->empty())
+                                    bump_allocators.erase(chunk);
+
+                                bump_allocators.unlink_erased();
+                            }
                         }
                         // no chunk exists, create a new one
                         else
+                        {
+                            tracer::record(tracer::Kind::Allocate, chunk_size);
                             bump_allocators.allocate_item();
+                        }
                     }
 
                     SPDLOG_TRACE("ChunkedBumpAlloc: alloc {},{}", blk.ptr, blk.len);
@@ -103,7 +221,7 @@ namespace redGrapes
                     SPDLOG_ERROR(
                         "ChunkedBumpAlloc: requested allocation of {} bytes exceeds chunk capacity of {} bytes",
                         alloc_size,
-                        chunk_capacity);
+                        chunk_capacity());
                     return Block::null();
                 }
             }
@@ -113,43 +231,162 @@ namespace redGrapes
                 TRACE_EVENT("Allocator", "ChunkedBumpAlloc::deallocate()");
                 SPDLOG_TRACE("ChunkedBumpAlloc[{}]: free {} {} ", (void*) this, (uintptr_t) blk.ptr, blk.len);
 
-                /* find the chunk that contains `ptr` and deallocate there.
-                 * Additionally, delete the chunk if possible.
-                 */
+                counters.on_deallocate(allocation_size(blk.len));
+
+                if(blk.len <= size_class::max_size
+                   && free_lists[size_class::index(blk.len)].push(blk, REDGRAPES_ALLOC_FREELIST_LIMIT))
+                    return;
+
+                if(is_large(blk.len))
+                    deallocate_large(blk);
+                else
+                    deallocate_to_chunk(blk);
+            }
+
+            /* free a block from a thread which does not own this arena.
+             * The block is pushed onto a lock-free list without touching
+             * any chunk or free list and is reclaimed later in a batch.
+             */
+            void deallocate_remote(Block blk)
+            {
+                TRACE_EVENT("Allocator", "ChunkedBumpAlloc::deallocate_remote()");
+                counters.on_remote_free();
+
+                RemoteNode* node = (RemoteNode*) blk.ptr;
+                node->len = blk.len;
+                node->next = remote_frees.load(std::memory_order_relaxed);
+                while(!remote_frees.compare_exchange_weak(
+                    node->next,
+                    node,
+                    std::memory_order_release,
+                    std::memory_order_relaxed))
+                    ;
+            }
+
+            /* take all blocks freed by remote threads so far
+             * and deallocate them locally.
+             * @return number of reclaimed blocks
+             */
+            unsigned reclaim_remote_frees()
+            {
+                if(!remote_frees.load(std::memory_order_relaxed))
+                    return 0;
 
-                auto prev = bump_allocators.rbegin();
-                for(auto it = bump_allocators.rbegin(); it != bump_allocators.rend(); ++it)
+                TRACE_EVENT("Allocator", "ChunkedBumpAlloc::reclaim_remote_frees()");
+                unsigned count = 0;
+                RemoteNode* node = remote_frees.exchange(nullptr, std::memory_order_acquire);
+                while(node)
                 {
-                    if(it->owns(blk))
-                    {
-                        /* if no allocations remain in this chunk
-                         * and this chunk is not `head`,
-                         * remove this chunk
-                         */
-                        if(it->deallocate(blk) == 1)
-                        {
-                            SPDLOG_TRACE("ChunkedBumpAlloc: erase chunk");
-                            if(it->full())
-                            {
-                                bump_allocators.erase(it);
-                                prev.optimize();
-                            }
-                        }
+                    RemoteNode* next = node->next;
+                    deallocate(Block{(uintptr_t) node, node->len});
+                    node = next;
+                    ++count;
+                }
+                return count;
+            }
 
-                        return;
-                    }
-                    prev = it;
+            //! take a snapshot of the allocator statistics
+            AllocStats stats() const
+            {
+                AllocStats stats;
+                counters.read(stats);
+
+                for(size_t i = 0; i < size_class::count; ++i)
+                    stats.bytes_cached += free_lists[i].length.load(std::memory_order_relaxed) * size_class::size(i);
+
+                stats.chunk_size = chunk_size;
+                auto head = bump_allocators.crbegin();
+                for(auto it = head; it != bump_allocators.crend(); ++it)
+                {
+                    ++stats.chunks_held;
+                    if(it != head && it->full() && it->active_allocations() == 1)
+                        ++stats.chunks_pinned;
                 }
 
+                if constexpr(requires { bump_allocators.alloc.cached_chunks(); })
+                    stats.chunks_cached = bump_allocators.alloc.cached_chunks();
+
+                return stats;
+            }
+
+            ~ChunkedBumpAlloc()
+            {
+                reclaim_remote_frees();
+
+                // give all cached blocks back to their chunks
+                for(auto& free_list : free_lists)
+                    while(Block blk = free_list.pop(0))
+                        deallocate_to_chunk(blk);
+            }
+
+        private:
+            Block allocate_large(size_t n) noexcept
+            {
+                TRACE_EVENT("Allocator", "ChunkedBumpAlloc::allocate_large()");
+                tracer::record(tracer::Kind::Allocate, n);
+
+                Block blk = bump_allocators.alloc.allocate(n);
+                if(blk)
+                    SPDLOG_TRACE("ChunkedBumpAlloc: alloc large {},{}", blk.ptr, blk.len);
+                else
+                    SPDLOG_ERROR("ChunkedBumpAlloc: allocation of large object with {} bytes failed", n);
+
+                return blk;
+            }
+
+            void deallocate_large(Block blk)
+            {
+                TRACE_EVENT("Allocator", "ChunkedBumpAlloc::deallocate_large()");
+                bump_allocators.alloc.deallocate(blk);
+            }
+
+            void deallocate_to_chunk(Block blk)
+            {
+                // the chunk that contains `ptr` is found via its alignment
+                auto chunk = bump_allocators.find_controlblock(blk.ptr);
+                BumpAllocator& bump_allocator = *chunk->get();
+
 #if REDGRAPES_ENABLE_BACKWARDCPP
-                SPDLOG_ERROR("try to deallocate invalid pointer ({}). this={}", (void*) blk.ptr, (void*) this);
+                if(!bump_allocator.owns(blk))
+                {
+                    SPDLOG_ERROR("try to deallocate invalid pointer ({}). this={}", (void*) blk.ptr, (void*) this);
 
-                backward::StackTrace st;
-                st.load_here(32);
-                backward::Printer p;
-                p.print(st);
+                    backward::StackTrace st;
+                    st.load_here(32);
+                    backward::Printer p;
+                    p.print(st);
+                    return;
+                }
 #endif
+
+                /* if no allocations remain in this chunk
+                 * and this chunk is not `head`,
+                 * remove this chunk. It gets unlinked
+                 * the next time a new chunk is appended.
+                 */
+                if(bump_allocator.deallocate(blk) == 1)
+                {
+                    SPDLOG_TRACE("ChunkedBumpAlloc: erase chunk");
+                    if(bump_allocator.full())
+                        bump_allocators.erase(chunk);
+                }
             }
+
+            std::array<FreeList, size_class::count> free_lists;
+
+            //! header written into remotely freed blocks
+            struct RemoteNode
+            {
+                RemoteNode* next;
+                size_t len;
+            };
+
+            static_assert(sizeof(RemoteNode) <= size_class::granularity);
+
+            //! blocks freed by other threads, waiting to be reclaimed
+            std::atomic<RemoteNode*> remote_frees{nullptr};
+
+            AllocCounters counters;
         };
 
     } // namespace memory
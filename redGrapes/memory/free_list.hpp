@@ -0,0 +1,66 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "redGrapes/memory/block.hpp"
+#include "redGrapes/sync/spinlock.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
+namespace redGrapes
+{
+    namespace memory
+    {
+
+        //! intrusive singly-linked list of freed blocks of the same size
+        struct FreeList
+        {
+            struct Node
+            {
+                Node* next;
+            };
+
+            SpinLock mutex;
+            Node* head = nullptr;
+
+            //! only modified under `mutex`, atomic to allow reading statistics
+            std::atomic<unsigned> length{0};
+
+            //! @return false if the list already holds `limit` blocks
+            bool push(Block blk, unsigned limit)
+            {
+                std::lock_guard<SpinLock> lock(mutex);
+                unsigned len = length.load(std::memory_order_relaxed);
+                if(len >= limit)
+                    return false;
+
+                Node* node = (Node*) blk.ptr;
+                node->next = head;
+                head = node;
+                length.store(len + 1, std::memory_order_relaxed);
+                return true;
+            }
+
+            //! @return the most recently pushed block with length `len`, or null if empty
+            Block pop(size_t len)
+            {
+                std::lock_guard<SpinLock> lock(mutex);
+                if(!head)
+                    return Block::null();
+
+                Node* node = head;
+                head = node->next;
+                length.store(length.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+                return Block{(uintptr_t) node, len};
+            }
+        };
+
+    } // namespace memory
+} // namespace redGrapes
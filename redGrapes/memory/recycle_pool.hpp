@@ -0,0 +1,130 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "redGrapes/memory/block.hpp"
+#include "redGrapes/memory/free_list.hpp"
+#include "redGrapes/memory/size_class.hpp"
+#include "redGrapes/util/trace.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/* number of distinct object sizes which can be recycled per worker,
+ * objects of further sizes go to the worker allocator directly
+ */
+#ifndef REDGRAPES_RECYCLE_POOL_BUCKETS
+#    define REDGRAPES_RECYCLE_POOL_BUCKETS 16
+#endif
+
+//! maximum number of blocks kept for each object size
+#ifndef REDGRAPES_RECYCLE_POOL_LIMIT
+#    define REDGRAPES_RECYCLE_POOL_LIMIT 1024
+#endif
+
+namespace redGrapes
+{
+    namespace memory
+    {
+
+        /* Keeps freed blocks of a worker arena for objects which are
+         * created and destroyed at a high rate, like task objects
+         * of the same type emplaced in a loop.
+         *
+         * Blocks are keyed by their exact length, which is in practice
+         * a key by type, so the next object of the same type gets the
+         * most recently freed (and thus warm) block.
+         * A bucket is claimed by the first object size that uses it
+         * and stays bound to this size.
+         *
+         * Only the owning worker puts blocks into its pool, blocks freed
+         * by other threads go back through the remote-free list of the arena,
+         * so the pool does not bounce between cores.
+         * Only sizes up to `size_class::max_size` are recycled.
+         */
+        struct RecyclePool
+        {
+            struct Bucket
+            {
+                //! length of the blocks in this bucket, 0 if unused
+                std::atomic<size_t> len{0};
+
+                FreeList list;
+            };
+
+            std::array<Bucket, REDGRAPES_RECYCLE_POOL_BUCKETS> buckets;
+
+            //! @return a recycled block of length `n_bytes`, or null if there is none
+            Block allocate(size_t n_bytes)
+            {
+                if(Bucket* bucket = find_bucket(n_bytes, false))
+                    return bucket->list.pop(n_bytes);
+
+                return Block::null();
+            }
+
+            //! @return false if the block was not taken and has to be freed otherwise
+            bool deallocate(Block blk)
+            {
+                TRACE_EVENT("Allocator", "RecyclePool::deallocate()");
+                if(Bucket* bucket = find_bucket(blk.len, true))
+                    return bucket->list.push(blk, REDGRAPES_RECYCLE_POOL_LIMIT);
+
+                return false;
+            }
+
+            //! number of bytes held by this pool
+            size_t bytes_cached() const
+            {
+                size_t n_bytes = 0;
+                for(Bucket const& bucket : buckets)
+                    n_bytes += bucket.len.load(std::memory_order_relaxed)
+                               * bucket.list.length.load(std::memory_order_relaxed);
+                return n_bytes;
+            }
+
+            //! remove all blocks from the pool and pass them to `free`
+            template<typename Free>
+            void drain(Free&& free)
+            {
+                for(Bucket& bucket : buckets)
+                    if(size_t len = bucket.len.load(std::memory_order_relaxed))
+                        while(Block blk = bucket.list.pop(len))
+                            free(blk);
+            }
+
+        private:
+            Bucket* find_bucket(size_t n_bytes, bool claim)
+            {
+                if(n_bytes == 0 || n_bytes > size_class::max_size)
+                    return nullptr;
+
+                for(Bucket& bucket : buckets)
+                {
+                    size_t len = bucket.len.load(std::memory_order_acquire);
+                    if(len == n_bytes)
+                        return &bucket;
+
+                    if(len == 0)
+                    {
+                        if(!claim)
+                            return nullptr;
+
+                        if(bucket.len.compare_exchange_strong(len, n_bytes, std::memory_order_acq_rel)
+                           || len == n_bytes)
+                            return &bucket;
+                    }
+                }
+
+                return nullptr;
+            }
+        };
+
+    } // namespace memory
+} // namespace redGrapes
@@ -0,0 +1,70 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+
+namespace redGrapes
+{
+    namespace memory
+    {
+
+        /* Size classes used by the worker allocators.
+         *
+         * Up to 128 bytes, classes are spaced by 16 bytes (16, 32, ..., 128).
+         * Above that, every power-of-two interval is split into four classes
+         * (160, 192, 224, 256, 320, ...), so rounding up wastes at most 25%
+         * instead of up to 50% with plain power-of-two rounding.
+         * All class sizes are multiples of 16 to keep allocations aligned.
+         */
+        namespace size_class
+        {
+            constexpr std::size_t granularity = 16;
+            constexpr std::size_t n_small = 8;
+            constexpr std::size_t small_limit = n_small * granularity;
+            constexpr std::size_t steps_per_pow2 = 4;
+
+            //! largest size which is served by a size class
+            constexpr std::size_t max_size = 4096;
+
+            //! index of the smallest class that can hold `n` bytes, requires n <= max_size
+            constexpr std::size_t index(std::size_t n)
+            {
+                if(n <= small_limit)
+                    return n == 0 ? 0 : (n - 1) / granularity;
+
+                std::size_t const log2 = std::bit_width(n - 1) - 1;
+                std::size_t const base = std::size_t(1) << log2;
+                std::size_t const step = base / steps_per_pow2;
+                std::size_t const k = (n - base + step - 1) / step;
+
+                return n_small + (log2 - std::bit_width(small_limit) + 1) * steps_per_pow2 + (k - 1);
+            }
+
+            //! number of bytes allocated for each block of class `idx`
+            constexpr std::size_t size(std::size_t idx)
+            {
+                if(idx < n_small)
+                    return (idx + 1) * granularity;
+
+                std::size_t const j = idx - n_small;
+                std::size_t const base = small_limit << (j / steps_per_pow2);
+                return base + (j % steps_per_pow2 + 1) * (base / steps_per_pow2);
+            }
+
+            constexpr std::size_t count = index(max_size) + 1;
+
+            static_assert(size(index(max_size)) == max_size);
+            static_assert(index(small_limit + 1) == n_small);
+            static_assert(size(n_small) == 160);
+
+        } // namespace size_class
+
+    } // namespace memory
+} // namespace redGrapes
@@ -12,6 +12,8 @@
 #include "redGrapes/globalSpace.hpp"
 #include "redGrapes/resource/fieldresource.hpp"
 #include "redGrapes/resource/ioresource.hpp"
+#include "redGrapes/resource/reductionresource.hpp"
+#include "redGrapes/resource/versionedresource.hpp"
 #include "redGrapes/scheduler/event.hpp"
 #include "redGrapes/scheduler/pool_scheduler.hpp"
 #include "redGrapes/task/task.hpp"
@@ -23,8 +25,11 @@
 #include <boost/mp11.hpp>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
 #include <memory>
 #include <new>
+#include <string>
+#include <vector>
 
 namespace redGrapes
 {
@@ -53,6 +58,7 @@ namespace redGrapes
                     TaskFreeCtx::n_workers,
                     TaskFreeCtx::n_pus);
 
+            TaskFreeCtx::pu_order = placement::pu_order(TaskFreeCtx::hwloc_ctx.topology, TaskFreeCtx::placement);
             TaskFreeCtx::worker_alloc_pool.allocs.reserve(TaskFreeCtx::n_workers);
 
             root_space = std::make_shared<TaskSpace>();
@@ -90,6 +96,25 @@ namespace redGrapes
         //! wait until all tasks in the current task space finished
         void barrier();
 
+        /*! wait until all previously emplaced tasks of the current task space
+         *  which conflict with the given resource accesses have finished,
+         *  while unrelated tasks keep running.
+         *
+         *  e.g. `rg.wait(buf.read())` waits for the writers of `buf`,
+         *  `rg.wait(buf)` or `rg.wait(buf.write())` for all its users.
+         *
+         *  The predecessors are found like for any other task: an empty task
+         *  with these accesses is emplaced and its result is awaited like with `Future::get()`,
+         *  so inside of a task this yields and requires stack switching.
+         *  Tasks emplaced afterwards which conflict with the accesses are ordered behind it.
+         */
+        template<typename... TAccess>
+        void wait(TAccess&&... accesses)
+        {
+            static_assert(sizeof...(TAccess) > 0, "wait() requires at least one resource access, use barrier()");
+            emplace_task([](auto&&...) {}, std::forward<TAccess>(accesses)...).get();
+        }
+
         //! pause the currently running task at least until event is reached
         //  TODO make this generic template<typename TEventPtr>
         void yield(scheduler::EventPtr<RGTask> event)
@@ -120,6 +145,51 @@ namespace redGrapes
             return scope_depth_impl();
         }
 
+        /*! take a snapshot of the allocator statistics of all workers.
+         *  The counters are only maintained if compiled with `REDGRAPES_ALLOC_STATS=1`,
+         *  otherwise only the state of chunks and free lists is reported.
+         *
+         * @return one entry per worker, indexed by WorkerId
+         */
+        std::vector<memory::AllocStats> memory_stats() const
+        {
+            std::vector<memory::AllocStats> stats;
+            for(WorkerId worker_id = 0; worker_id < TaskFreeCtx::n_workers; ++worker_id)
+            {
+                memory::AllocStats s = TaskFreeCtx::worker_alloc_pool.get_alloc(worker_id).stats();
+
+                // blocks in the recycle pool are still allocated from the arena's point of view
+                size_t recycled = TaskFreeCtx::worker_alloc_pool.get_recycle_pool(worker_id).bytes_cached();
+                s.bytes_live -= std::min(s.bytes_live, recycled);
+                s.bytes_cached += recycled;
+
+                stats.push_back(s);
+            }
+            return stats;
+        }
+
+        /*! take a snapshot of the scheduler counters of all workers.
+         *  Workers of schedulers which do not maintain counters are reported as zero.
+         *
+         * @return one entry per worker, indexed by WorkerId
+         */
+        std::vector<scheduler::SchedulerStats> scheduler_stats()
+        {
+            std::vector<scheduler::SchedulerStats> stats(TaskFreeCtx::n_workers);
+            boost::mp11::mp_for_each<TSchedMap>(
+                [&](auto pair) { scheduler_map[boost::mp11::mp_first<decltype(pair)>{}]->read_stats(stats); });
+            return stats;
+        }
+
+        /*! let the scheduler counters of all workers start over from zero, e.g. at the begin of a new phase.
+         *  May be called while the workers are running.
+         */
+        void reset_scheduler_stats()
+        {
+            boost::mp11::mp_for_each<TSchedMap>(
+                [&](auto pair) { scheduler_map[boost::mp11::mp_first<decltype(pair)>{}]->reset_stats(); });
+        }
+
         /*! create a new task, as child of the currently running task (if there is one)
          *
          * @param f callable that takes "proprty-building" objects as args
@@ -142,7 +212,7 @@ namespace redGrapes
             using Impl = typename std::invoke_result_t<BindArgs<Callable, Args...>, Callable, Args...>;
             // this is not set to nullptr. But it goes out of scope. Memory is managed by allocate
             FunTask<Impl, RGTask>* task;
-            memory::Allocator alloc(worker_id);
+            memory::RecyclingAllocator alloc(worker_id);
             memory::Block blk = alloc.allocate(sizeof(FunTask<Impl, RGTask>));
             task = (FunTask<Impl, RGTask>*) blk.ptr;
             SPDLOG_TRACE("Allocated Task of size {}", sizeof(FunTask<Impl, RGTask>));
@@ -213,6 +283,12 @@ namespace redGrapes
 #if REDGRAPES_ENABLE_TRACE
         std::shared_ptr<perfetto::TracingSession> tracing_session;
 #endif
+
+        //! file to write the trace of the built-in tracer to at shutdown
+        std::string trace_file;
+
+        //! file to write the recorded task graph to at shutdown
+        std::string task_graph_file;
     };
 
     // TODO make sure init can only be called once
@@ -10,10 +10,14 @@
 #include "redGrapes/TaskFreeCtx.hpp"
 #include "redGrapes/globalSpace.hpp"
 #include "redGrapes/redGrapes.hpp"
+#include "redGrapes/util/graph_recorder.hpp"
+#include "redGrapes/util/perf_counters.hpp"
 #include "redGrapes/util/trace.hpp"
+#include "redGrapes/util/tracer.hpp"
 
 #include <moodycamel/concurrentqueue.h>
 
+#include <cstdlib>
 #include <functional>
 
 #if REDGRAPES_ENABLE_TRACE
@@ -47,6 +51,28 @@ namespace redGrapes
 
         tracing_session = StartTracing();
 #endif
+
+#if REDGRAPES_TRACER
+        tracer::set_thread_name("main");
+        if(char const* path = std::getenv("REDGRAPES_TRACE"))
+        {
+            trace_file = path;
+            tracer::enable();
+        }
+#endif
+
+#if REDGRAPES_GRAPH_RECORDER
+        if(char const* path = std::getenv("REDGRAPES_TASK_GRAPH"))
+        {
+            task_graph_file = path;
+            graph_recorder::enable();
+        }
+#endif
+
+#if REDGRAPES_PERF_COUNTERS
+        if(std::getenv("REDGRAPES_PERF_COUNTERS"))
+            perf_counters::enable();
+#endif
     }
 
     template<typename TSchedMap, C_TaskProperty... TUserTaskProperties>
@@ -55,6 +81,26 @@ namespace redGrapes
 #if REDGRAPES_ENABLE_TRACE
         StopTracing(tracing_session);
 #endif
+
+        if(!trace_file.empty())
+        {
+            if(tracer::write_chrome_json(trace_file))
+                SPDLOG_INFO("wrote trace to {}", trace_file);
+            else
+                SPDLOG_ERROR("could not write trace to {}", trace_file);
+        }
+
+        if(!task_graph_file.empty())
+        {
+            if(graph_recorder::write(task_graph_file))
+                SPDLOG_INFO("wrote task graph to {}", task_graph_file);
+            else
+                SPDLOG_ERROR("could not write task graph to {}", task_graph_file);
+        }
+
+        if(perf_counters::is_enabled())
+            for(auto const& [label, summary] : perf_counters::summaries())
+                SPDLOG_INFO("performance counters of tasks \"{}\": {}", label, summary);
     }
 
     /*! wait until all tasks in the current task space finished
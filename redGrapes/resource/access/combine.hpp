@@ -30,6 +30,16 @@ namespace redGrapes
         {
         };
 
+        //! policies without `is_commutative()` never are
+        template<typename Access>
+        bool is_commutative(Access const& a)
+        {
+            if constexpr(requires { a.is_commutative(); })
+                return a.is_commutative();
+            else
+                return false;
+        }
+
         template<typename Access, size_t N, typename Op = Or_t>
         struct ArrayAccess : std::array<Access, N>
         {
@@ -52,6 +62,16 @@ namespace redGrapes
                 return true;
             }
 
+            //! the whole resource is locked if any element is commutative
+            bool is_commutative() const
+            {
+                for(std::size_t i = 0; i < N; ++i)
+                    if(access::is_commutative((*this)[i]))
+                        return true;
+
+                return false;
+            }
+
             //! both array accesses are only serial if all element pairs are serial
             static bool is_serial(ArrayAccess<Access, N, Or_t> const& a, ArrayAccess<Access, N, Or_t> const& b)
             {
@@ -116,6 +136,14 @@ namespace redGrapes
                 return this->first.is_synchronizing() && this->second.is_synchronizing();
             }
 
+            /* if one part is commutative, accesses which are not serial may still not run
+             * at the same time, so the whole resource is locked, e.g. all areas of a field
+             */
+            bool is_commutative() const
+            {
+                return access::is_commutative(this->first) || access::is_commutative(this->second);
+            }
+
             static bool is_serial(CombineAccess<Acc1, Acc2, Or_t> const& a, CombineAccess<Acc1, Acc2, Or_t> const& b)
             {
                 return (Acc1::is_serial(a.first, b.first) || Acc2::is_serial(a.second, b.second));
@@ -28,6 +28,12 @@ namespace redGrapes
                 read,
                 aadd,
                 amul,
+
+                //! concurrent updates of private accumulators, see `ReductionResource`
+                reduce,
+
+                //! mutually exclusive like write, but in any order among each other
+                commute,
             } mode;
 
             IOAccess() : mode(write)
@@ -43,6 +49,12 @@ namespace redGrapes
                 return mode == write;
             }
 
+            //! tasks with commutative access are not ordered, but never run at the same time
+            bool is_commutative() const
+            {
+                return mode == commute;
+            }
+
             bool operator==(IOAccess const& other) const
             {
                 return this->mode == other.mode;
@@ -52,7 +64,8 @@ namespace redGrapes
             {
                 return !(
                     (a.mode == read && b.mode == read) || (a.mode == aadd && b.mode == aadd)
-                    || (a.mode == amul && b.mode == amul));
+                    || (a.mode == amul && b.mode == amul) || (a.mode == reduce && b.mode == reduce)
+                    || (a.mode == commute && b.mode == commute));
             }
 
             bool is_superset_of(IOAccess a) const
@@ -92,6 +105,12 @@ struct fmt::formatter<redGrapes::access::IOAccess>
         case redGrapes::access::IOAccess::amul:
             mode_str = "atomicMul";
             break;
+        case redGrapes::access::IOAccess::reduce:
+            mode_str = "reduce";
+            break;
+        case redGrapes::access::IOAccess::commute:
+            mode_str = "commute";
+            break;
         }
 
         return fmt::format_to(ctx.out(), "{{ \"IOAccess\" : \"{}\" }}", mode_str);
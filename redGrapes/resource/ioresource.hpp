@@ -77,6 +77,41 @@ namespace redGrapes
             }
         };
 
+        //! exclusive access to the object, but unordered among other commutative accesses
+        template<typename T>
+        struct CommuteGuard : public SharedResourceObject<T, access::IOAccess>
+        {
+            CommuteGuard(Resource<access::IOAccess> const& res, std::shared_ptr<T> const& obj)
+                : SharedResourceObject<T, access::IOAccess>(res, obj)
+            {
+            }
+
+            operator ResourceAccess() const noexcept
+            {
+                return this->make_access(access::IOAccess::commute);
+            }
+
+            CommuteGuard commute() const noexcept
+            {
+                return *this;
+            }
+
+            T& operator*() const noexcept
+            {
+                return *this->obj;
+            }
+
+            T* operator->() const noexcept
+            {
+                return this->obj.get();
+            }
+
+            T* get() const noexcept
+            {
+                return this->obj.get();
+            }
+        };
+
         template<typename T>
         struct WriteGuard : public ReadGuard<T>
         {
@@ -90,6 +125,11 @@ namespace redGrapes
                 return *this;
             }
 
+            CommuteGuard<T> commute() const noexcept
+            {
+                return CommuteGuard<T>(*this, this->obj);
+            }
+
             T& operator*() const noexcept
             {
                 return *this->obj;
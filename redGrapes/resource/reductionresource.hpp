@@ -0,0 +1,216 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * @file redGrapes/resource/reductionresource.hpp
+ */
+
+#pragma once
+
+#include "redGrapes/TaskFreeCtx.hpp"
+#include "redGrapes/resource/access/io.hpp"
+#include "redGrapes/resource/resource.hpp"
+#include "redGrapes/sync/spinlock.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace redGrapes
+{
+    namespace reductionresource
+    {
+
+        /* shared value together with one private accumulator per worker.
+         *
+         * Tasks with `reduce` access only update the accumulator of the worker they run on,
+         * so concurrent updates never share a cache line.
+         * The accumulators are combined into the value the first time it is dereferenced by
+         * a task with read or write access, which is ordered after all preceding reductions.
+         */
+        template<typename T, typename Op>
+        struct Accumulators
+        {
+            struct alignas(64) Slot
+            {
+                T value;
+                bool used = false;
+            };
+
+            T value;
+            T identity;
+            Op op;
+
+            //! one per worker and one for threads which are no worker, e.g. the main thread
+            std::vector<Slot> slots;
+
+            std::atomic<bool> pending{false};
+            SpinLock merge_mutex;
+
+            Accumulators(T const& identity, Op op)
+                : value(identity)
+                , identity(identity)
+                , op(op)
+                , slots(TaskFreeCtx::n_workers + 1, Slot{identity})
+            {
+            }
+
+            //! accumulator of the calling worker
+            T& local()
+            {
+                size_t const worker = TaskFreeCtx::current_worker_id.value_or(slots.size() - 1);
+                Slot& slot = slots[std::min(worker, slots.size() - 1)];
+                if(!slot.used)
+                {
+                    slot.used = true;
+                    pending.store(true, std::memory_order_relaxed);
+                }
+                return slot.value;
+            }
+
+            //! combine all accumulators into the value
+            T& merged()
+            {
+                if(pending.load(std::memory_order_acquire))
+                {
+                    // concurrent readers
+                    std::lock_guard<SpinLock> lock(merge_mutex);
+                    if(pending.load(std::memory_order_relaxed))
+                    {
+                        for(Slot& slot : slots)
+                            if(slot.used)
+                            {
+                                value = op(value, slot.value);
+                                slot.value = identity;
+                                slot.used = false;
+                            }
+                        pending.store(false, std::memory_order_release);
+                    }
+                }
+                return value;
+            }
+        };
+
+        template<typename T, typename Op>
+        struct ReduceGuard : public SharedResourceObject<Accumulators<T, Op>, access::IOAccess>
+        {
+            operator ResourceAccess() const noexcept
+            {
+                return this->make_access(access::IOAccess::reduce);
+            }
+
+            ReduceGuard reduce() const noexcept
+            {
+                return *this;
+            }
+
+            //! private accumulator of the current worker, starts at the identity
+            T& operator*() const noexcept
+            {
+                return this->obj->local();
+            }
+
+            T* operator->() const noexcept
+            {
+                return &this->obj->local();
+            }
+
+        protected:
+            template<typename... Args>
+            ReduceGuard(ResourceId id, Args&&... args)
+                : SharedResourceObject<Accumulators<T, Op>, access::IOAccess>(id, std::forward<Args>(args)...)
+            {
+            }
+        };
+
+        template<typename T, typename Op>
+        struct ReadGuard : public ReduceGuard<T, Op>
+        {
+            operator ResourceAccess() const noexcept
+            {
+                return this->make_access(access::IOAccess::read);
+            }
+
+            ReadGuard read() const noexcept
+            {
+                return *this;
+            }
+
+            T const& operator*() const noexcept
+            {
+                return this->obj->merged();
+            }
+
+            T const* operator->() const noexcept
+            {
+                return &this->obj->merged();
+            }
+
+        protected:
+            template<typename... Args>
+            ReadGuard(ResourceId id, Args&&... args) : ReduceGuard<T, Op>(id, std::forward<Args>(args)...)
+            {
+            }
+        };
+
+        template<typename T, typename Op>
+        struct WriteGuard : public ReadGuard<T, Op>
+        {
+            operator ResourceAccess() const noexcept
+            {
+                return this->make_access(access::IOAccess::write);
+            }
+
+            WriteGuard write() const noexcept
+            {
+                return *this;
+            }
+
+            T& operator*() const noexcept
+            {
+                return this->obj->merged();
+            }
+
+            T* operator->() const noexcept
+            {
+                return &this->obj->merged();
+            }
+
+        protected:
+            template<typename... Args>
+            WriteGuard(ResourceId id, Args&&... args) : ReadGuard<T, Op>(id, std::forward<Args>(args)...)
+            {
+            }
+        };
+
+    } // namespace reductionresource
+
+    /* Resource for reductions like sums or histograms.
+     *
+     * Tasks emplaced with `res.reduce()` may run concurrently and each one
+     * updates the private accumulator of its worker, e.g. `*acc += x`.
+     * Accumulators start at `identity` and are combined into the value with
+     * `value = op(value, accumulator)` when a task with `res.read()` or `res.write()`
+     * access, or the owner of the resource, dereferences it.
+     * `op` therefore has to be associative and commutative.
+     *
+     * Like other resources, it must be created after the runtime was initialized,
+     * which determines the number of accumulators.
+     */
+    template<typename T, typename Op = std::plus<T>>
+    struct ReductionResource : public reductionresource::WriteGuard<T, Op>
+    {
+        ReductionResource(T const& identity = T{}, Op op = Op{})
+            : reductionresource::WriteGuard<T, Op>(TaskFreeCtx::create_resource_uid(), identity, op)
+        {
+        }
+    }; // struct ReductionResource
+
+} // namespace redGrapes
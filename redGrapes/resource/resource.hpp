@@ -20,6 +20,7 @@
 #include <boost/type_index.hpp>
 #include <fmt/format.h>
 
+#include <deque>
 #include <memory>
 #include <string>
 #include <type_traits>
@@ -72,6 +73,13 @@ namespace redGrapes
         ResourceId id;
         uint8_t scope_level;
 
+        //! task which currently holds a commutative access, see `GraphProperty::try_lock_commutative()`
+        ResourceUser* commute_owner = nullptr;
+
+        //! ready tasks with commutative access, which wait for the owner to hand the resource over (FIFO)
+        std::deque<ResourceUser*> commute_waiters;
+        SpinLock commute_mutex;
+
         /**
          * Create a new resource with an unused ID.
          */
@@ -111,6 +119,7 @@ namespace redGrapes
             }
 
             virtual bool is_synchronizing() const = 0;
+            virtual bool is_commutative() const = 0;
             virtual bool is_serial(AccessBase const& r) const = 0;
             virtual bool is_superset_of(AccessBase const& r) const = 0;
             virtual std::string mode_format() const = 0;
@@ -165,6 +174,11 @@ namespace redGrapes
             return this->obj->is_synchronizing();
         }
 
+        bool is_commutative() const
+        {
+            return this->obj->is_commutative();
+        }
+
         unsigned int scope_level() const
         {
             return this->obj->resource->scope_level;
@@ -290,6 +304,15 @@ namespace redGrapes
                 return policy.is_synchronizing();
             }
 
+            //! access policies may provide `is_commutative()`, see `IOAccess::commute`
+            bool is_commutative() const override
+            {
+                if constexpr(requires { policy.is_commutative(); })
+                    return policy.is_commutative();
+                else
+                    return false;
+            }
+
             bool is_serial(typename ResourceAccess::AccessBase const& a_) const override
             {
                 Access const& a
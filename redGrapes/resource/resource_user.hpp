@@ -53,6 +53,7 @@ namespace redGrapes
             : access_list(memory::Allocator(worker_id), other.access_list)
             , unique_resources(memory::Allocator(worker_id), other.unique_resources)
             , scope_level(other.scope_level)
+            , has_commutative(other.has_commutative)
         {
         }
 
@@ -70,6 +71,7 @@ namespace redGrapes
             this->access_list.push(ra);
             std::shared_ptr<ResourceBase> r = ra.get_resource();
             unique_resources.push(ResourceUsageEntry{r, r->users.rend()});
+            has_commutative = has_commutative || ra.is_commutative();
         }
 
         void rm_resource_access(ResourceAccess ra)
@@ -84,6 +86,7 @@ namespace redGrapes
                 std::shared_ptr<ResourceBase> r = ra->get_resource();
                 unique_resources.erase(ResourceUsageEntry{r, r->users.rend()});
                 unique_resources.push(ResourceUsageEntry{r, r->users.rend()});
+                has_commutative = has_commutative || ra->is_commutative();
             }
         }
 
@@ -130,6 +133,10 @@ namespace redGrapes
         ChunkedList<ResourceAccess, 8> access_list;
         ChunkedList<ResourceUsageEntry, 8> unique_resources;
         uint8_t scope_level;
+
+        //! at least one access is commutative, so the task has to lock the resource before it runs
+        bool has_commutative = false;
+
         //! task space that contains this task, must not be null
         std::shared_ptr<TaskSpace> space;
 
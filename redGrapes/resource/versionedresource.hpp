@@ -0,0 +1,161 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * @file redGrapes/resource/versionedresource.hpp
+ */
+
+#pragma once
+
+#include "redGrapes/resource/ioresource.hpp"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace redGrapes
+{
+    namespace versionedresource
+    {
+
+        //! buffers of versions which are no longer referenced by any task
+        template<typename T>
+        struct Pool
+        {
+            //! a buffer keeps the resource id it was first created with
+            struct Buffer
+            {
+                ResourceId id;
+                std::unique_ptr<T> obj;
+            };
+
+            std::function<std::unique_ptr<T>()> make;
+
+            std::mutex mutex;
+            std::vector<Buffer> free;
+            size_t allocated = 0;
+
+            Pool(std::function<std::unique_ptr<T>()> make) : make(std::move(make))
+            {
+            }
+
+            //! a recycled buffer if there is one, otherwise a new one with a new resource id
+            std::pair<ResourceId, std::shared_ptr<T>> acquire(std::shared_ptr<Pool> const& self)
+            {
+                Buffer buffer;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if(!free.empty())
+                    {
+                        buffer = std::move(free.back());
+                        free.pop_back();
+                    }
+                    else
+                        allocated++;
+                }
+                if(!buffer.obj)
+                {
+                    buffer.id = TaskFreeCtx::create_resource_uid();
+                    buffer.obj = make();
+                }
+
+                // the buffer goes back once the last guard of this version is gone
+                ResourceId const id = buffer.id;
+                return {id,
+                        std::shared_ptr<T>(
+                            buffer.obj.release(),
+                            [self, id](T* p)
+                            {
+                                std::lock_guard<std::mutex> lock(self->mutex);
+                                self->free.push_back(Buffer{id, std::unique_ptr<T>(p)});
+                            })};
+            }
+        };
+
+        //! one version, constructed from a buffer of the pool
+        template<typename T>
+        struct Version : ioresource::WriteGuard<T>
+        {
+            Version(std::pair<ResourceId, std::shared_ptr<T>> const& buffer)
+                : ioresource::WriteGuard<T>(buffer.first, buffer.second)
+            {
+            }
+        };
+
+    } // namespace versionedresource
+
+    /* IOResource which is renamed on every complete overwrite.
+     *
+     * Each version is a separate resource with its own buffer.
+     * A task emplaced with `res.overwrite()` gets write access to a fresh version,
+     * so it neither waits for the readers nor for the writers of the previous versions,
+     * and all tasks emplaced afterwards access the new version.
+     * The content of the fresh buffer is unspecified, it is either newly constructed
+     * with the arguments of the first version or recycled from a version whose
+     * tasks have all finished.
+     * A recycled buffer also reuses the resource id of its previous version,
+     * so the number of ids consumed is bounded by the number of buffers
+     * and not by the number of overwrites.
+     * `read()` and `write()` access the current version like with `IOResource`.
+     *
+     * Like emplacing tasks, `overwrite()` must not be called concurrently.
+     */
+    template<typename T>
+    class VersionedResource
+    {
+    public:
+        //! all versions are constructed from copies of `args`
+        template<typename... Args>
+        explicit VersionedResource(Args const&... args)
+            : pool(std::make_shared<versionedresource::Pool<T>>([args...] { return std::make_unique<T>(args...); }))
+            , current(pool->acquire(pool))
+        {
+        }
+
+        ioresource::ReadGuard<T> read() const noexcept
+        {
+            return current.read();
+        }
+
+        ioresource::WriteGuard<T> write() const noexcept
+        {
+            return current.write();
+        }
+
+        //! start a new version which replaces the whole object
+        ioresource::WriteGuard<T> overwrite()
+        {
+            current = versionedresource::Version<T>(pool->acquire(pool));
+            return current.write();
+        }
+
+        //! the current version, only valid while no task accesses it
+        T& operator*() const noexcept
+        {
+            return *current;
+        }
+
+        T* operator->() const noexcept
+        {
+            return current.get();
+        }
+
+        //! number of buffers allocated so far, the others were recycled
+        size_t buffers() const
+        {
+            std::lock_guard<std::mutex> lock(pool->mutex);
+            return pool->allocated;
+        }
+
+    private:
+        std::shared_ptr<versionedresource::Pool<T>> pool;
+        versionedresource::Version<T> current;
+    }; // class VersionedResource
+
+} // namespace redGrapes
@@ -36,12 +36,9 @@ namespace redGrapes
                 // TODO check if it was already initalized
                 if(!this->m_worker_thread)
                 {
-                    WorkerId pu_id = base_id % TaskFreeCtx::n_pus;
                     // allocate worker with id `i` on arena `i`,
-                    hwloc_obj_t obj = hwloc_get_obj_by_type(TaskFreeCtx::hwloc_ctx.topology, HWLOC_OBJ_PU, pu_id);
-                    TaskFreeCtx::worker_alloc_pool.allocs.emplace_back(
-                        memory::HwlocAlloc(TaskFreeCtx::hwloc_ctx, obj),
-                        REDGRAPES_ALLOC_CHUNKSIZE);
+                    hwloc_obj_t obj = TaskFreeCtx::get_worker_pu(base_id);
+                    TaskFreeCtx::worker_alloc_pool.add_arena(TaskFreeCtx::hwloc_ctx, obj);
 
                     this->m_worker_thread
                         = memory::alloc_shared_bind<dispatch::thread::WorkerThread<dispatch::cuda::CudaWorker<TTask>>>(
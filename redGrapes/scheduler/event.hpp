@@ -15,11 +15,19 @@
 
 #include <atomic>
 #include <memory>
+#include <type_traits>
 
 #ifndef REDGRAPES_EVENT_FOLLOWER_LIST_CHUNKSIZE
 #    define REDGRAPES_EVENT_FOLLOWER_LIST_CHUNKSIZE 16
 #endif
 
+/* if enabled, the chunks of follower lists are kept in the recycle pool
+ * of their worker and reused by the events of subsequent tasks
+ */
+#ifndef REDGRAPES_RECYCLE_FOLLOWER_CHUNKS
+#    define REDGRAPES_RECYCLE_FOLLOWER_CHUNKS 1
+#endif
+
 
 namespace redGrapes
 {
@@ -85,8 +93,11 @@ namespace redGrapes
         template<typename TTask>
         struct Event
         {
+            using FollowerAllocator
+                = std::conditional_t<REDGRAPES_RECYCLE_FOLLOWER_CHUNKS, memory::RecyclingAllocator, memory::Allocator>;
+
             //! the set of subsequent events
-            ChunkedList<EventPtr<TTask>, REDGRAPES_EVENT_FOLLOWER_LIST_CHUNKSIZE> followers;
+            ChunkedList<EventPtr<TTask>, REDGRAPES_EVENT_FOLLOWER_LIST_CHUNKSIZE, FollowerAllocator> followers;
 
             /*! number of incoming edges
              * state == 0: event is reached and can be removed
@@ -8,6 +8,7 @@
 
 #include "redGrapes/TaskFreeCtx.hpp"
 #include "redGrapes/scheduler/event.hpp"
+#include "redGrapes/task/property/timing.hpp"
 #include "redGrapes/util/trace.hpp"
 
 #include <spdlog/spdlog.h>
@@ -20,7 +21,7 @@ namespace redGrapes
     namespace scheduler
     {
         template<typename TTask>
-        Event<TTask>::Event(WorkerId worker_id) : followers(memory::Allocator(worker_id))
+        Event<TTask>::Event(WorkerId worker_id) : followers(FollowerAllocator(worker_id))
                                                 , state(1)
                                                 , waker_id(-1)
         {
@@ -28,7 +29,7 @@ namespace redGrapes
 
         template<typename TTask>
         Event<TTask>::Event(WorkerId worker_id, Event& other)
-            : followers(memory::Allocator(worker_id))
+            : followers(FollowerAllocator(worker_id))
             , state((uint16_t) other.state)
             , waker_id(other.waker_id)
         {
@@ -36,7 +37,7 @@ namespace redGrapes
 
         template<typename TTask>
         Event<TTask>::Event(WorkerId worker_id, Event&& other)
-            : followers(memory::Allocator(worker_id))
+            : followers(FollowerAllocator(worker_id))
             , state((uint16_t) other.state)
             , waker_id(other.waker_id)
         {
@@ -158,6 +159,11 @@ namespace redGrapes
             // pre event ready
             if(tag == scheduler::T_EVT_PRE && state == 1)
             {
+                // otherwise the task waits for a commutative resource and is notified again on its release
+                if(task->has_commutative && !task->try_lock_commutative())
+                    return false;
+
+                timing::stamp(*task, timing::Stage::Ready);
                 if(!claimed)
                     task->scheduler_p->activate_task(*task);
             }
@@ -169,7 +175,11 @@ namespace redGrapes
                 // no other task can now create dependencies to this
                 // task after deleting it from the resource list
                 if(tag == scheduler::T_EVT_POST)
+                {
                     task->delete_from_resources();
+                    if(task->has_commutative)
+                        task->unlock_commutative();
+                }
 
                 // test for state == 0 is not strictly required as no one adds a follower to result set
                 // TODO FIX! if .submit() is called inside a child task, we dont wake the parser
@@ -60,6 +60,10 @@ namespace redGrapes
             void startExecution();
 
             void stopExecution();
+
+            void read_stats(std::vector<SchedulerStats>& stats);
+
+            void reset_stats();
         };
 
     } // namespace scheduler
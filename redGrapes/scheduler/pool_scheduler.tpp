@@ -148,6 +148,20 @@ namespace redGrapes
             m_worker_pool.stop();
         }
 
+        template<typename Worker>
+        void PoolScheduler<Worker>::read_stats(std::vector<SchedulerStats>& stats)
+        {
+            for(WorkerId i = 0; i < n_workers; ++i)
+                m_worker_pool.get_worker_thread(i).worker.counters.read(stats.at(m_base_id + i));
+        }
+
+        template<typename Worker>
+        void PoolScheduler<Worker>::reset_stats()
+        {
+            for(WorkerId i = 0; i < n_workers; ++i)
+                m_worker_pool.get_worker_thread(i).worker.counters.reset();
+        }
+
 
     } // namespace scheduler
 } // namespace redGrapes
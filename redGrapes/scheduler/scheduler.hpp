@@ -8,9 +8,12 @@
 #pragma once
 
 #include "redGrapes/TaskFreeCtx.hpp"
+#include "redGrapes/scheduler/scheduler_stats.hpp"
 
 #include <spdlog/spdlog.h>
 
+#include <vector>
+
 namespace redGrapes
 {
     namespace scheduler
@@ -74,6 +77,16 @@ namespace redGrapes
             virtual void stopExecution()
             {
             }
+
+            //! write the counters of each worker to `stats`, indexed by WorkerId
+            virtual void read_stats(std::vector<SchedulerStats>&)
+            {
+            }
+
+            //! set all worker counters to zero, e.g. at the begin of a new phase
+            virtual void reset_stats()
+            {
+            }
         };
 
     } // namespace scheduler
@@ -0,0 +1,371 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "redGrapes/sync/cv.hpp"
+
+#include <fmt/format.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+
+/* if enabled, every worker maintains counters
+ * which can be read with `RedGrapes::scheduler_stats()`.
+ */
+#ifndef REDGRAPES_SCHEDULER_STATS
+#    define REDGRAPES_SCHEDULER_STATS 1
+#endif
+
+namespace redGrapes
+{
+    namespace scheduler
+    {
+
+        //! snapshot of the counters of one worker
+        struct SchedulerStats
+        {
+            //! number of task executions, a task which is resumed after an event counts again
+            size_t tasks_executed = 0;
+
+            //! tasks whose dependencies were inserted into the task graph by this worker
+            size_t tasks_initialized = 0;
+
+            //! tasks taken from the own ready queue
+            size_t ready_pops = 0;
+
+            //! tasks taken from the own emplacement queue
+            size_t emplacement_pops = 0;
+
+            //! attempts and successes to steal ready tasks from other workers
+            size_t steal_ready_attempts = 0;
+            size_t steal_ready_successes = 0;
+
+            //! attempts and successes to steal uninitialized tasks from other workers
+            size_t steal_new_attempts = 0;
+            size_t steal_new_successes = 0;
+
+            //! searches for an available worker to activate a ready task on, and those which found none
+            size_t free_worker_searches = 0;
+            size_t free_worker_misses = 0;
+
+            /*! bits of the worker-state bitfield visited while searching
+             *  for an available worker or a worker to steal from
+             */
+            size_t bitfield_probes = 0;
+
+            //! available workers which another thread claimed first
+            size_t claim_conflicts = 0;
+
+            //! wakeups of sleeping workers issued by this worker
+            size_t wakeups_sent = 0;
+
+            //! wakeups this worker received while sleeping or about to sleep
+            size_t wakeups_received = 0;
+
+            //! iterations spent polling the condition variable before sleeping
+            size_t spin_iterations = 0;
+
+            //! number of times the worker was put to sleep and the total time it slept
+            size_t parks = 0;
+            uint64_t parked_ns = 0;
+
+            SchedulerStats& operator+=(SchedulerStats const& other)
+            {
+                tasks_executed += other.tasks_executed;
+                tasks_initialized += other.tasks_initialized;
+                ready_pops += other.ready_pops;
+                emplacement_pops += other.emplacement_pops;
+                steal_ready_attempts += other.steal_ready_attempts;
+                steal_ready_successes += other.steal_ready_successes;
+                steal_new_attempts += other.steal_new_attempts;
+                steal_new_successes += other.steal_new_successes;
+                free_worker_searches += other.free_worker_searches;
+                free_worker_misses += other.free_worker_misses;
+                bitfield_probes += other.bitfield_probes;
+                claim_conflicts += other.claim_conflicts;
+                wakeups_sent += other.wakeups_sent;
+                wakeups_received += other.wakeups_received;
+                spin_iterations += other.spin_iterations;
+                parks += other.parks;
+                parked_ns += other.parked_ns;
+                return *this;
+            }
+
+            SchedulerStats& operator-=(SchedulerStats const& other)
+            {
+                tasks_executed -= other.tasks_executed;
+                tasks_initialized -= other.tasks_initialized;
+                ready_pops -= other.ready_pops;
+                emplacement_pops -= other.emplacement_pops;
+                steal_ready_attempts -= other.steal_ready_attempts;
+                steal_ready_successes -= other.steal_ready_successes;
+                steal_new_attempts -= other.steal_new_attempts;
+                steal_new_successes -= other.steal_new_successes;
+                free_worker_searches -= other.free_worker_searches;
+                free_worker_misses -= other.free_worker_misses;
+                bitfield_probes -= other.bitfield_probes;
+                claim_conflicts -= other.claim_conflicts;
+                wakeups_sent -= other.wakeups_sent;
+                wakeups_received -= other.wakeups_received;
+                spin_iterations -= other.spin_iterations;
+                parks -= other.parks;
+                parked_ns -= other.parked_ns;
+                return *this;
+            }
+        };
+
+        /* counters maintained by each worker.
+         * Most of them are only written by the owning worker,
+         * received wakeups are counted by the waking thread.
+         * All updates are relaxed, so a snapshot taken while
+         * workers are running is only approximate.
+         *
+         * The counters themselves are never reset, since a store from a foreign
+         * thread could be overwritten by a concurrent increment of the owner.
+         * Instead `reset()` records a baseline which `read()` subtracts.
+         */
+        struct WorkerCounters
+        {
+            //! counters of the worker running on the calling thread, null on other threads
+            static inline thread_local WorkerCounters* current = nullptr;
+
+#if REDGRAPES_SCHEDULER_STATS
+            std::atomic<size_t> tasks_executed{0};
+            std::atomic<size_t> tasks_initialized{0};
+            std::atomic<size_t> ready_pops{0};
+            std::atomic<size_t> emplacement_pops{0};
+            std::atomic<size_t> steal_ready_attempts{0};
+            std::atomic<size_t> steal_ready_successes{0};
+            std::atomic<size_t> steal_new_attempts{0};
+            std::atomic<size_t> steal_new_successes{0};
+            std::atomic<size_t> free_worker_searches{0};
+            std::atomic<size_t> free_worker_misses{0};
+            std::atomic<size_t> bitfield_probes{0};
+            std::atomic<size_t> claim_conflicts{0};
+            std::atomic<size_t> wakeups_sent{0};
+            std::atomic<size_t> wakeups_received{0};
+            std::atomic<size_t> spin_iterations{0};
+            std::atomic<size_t> parks{0};
+            std::atomic<uint64_t> parked_ns{0};
+
+            /* all counters except `wakeups_received` are only written by the thread
+             * of the worker they belong to, so they need no locked read-modify-write
+             */
+            template<typename T>
+            static inline void add(std::atomic<T>& counter, std::type_identity_t<T> n)
+            {
+                counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+            }
+
+            inline void on_execute()
+            {
+                add(tasks_executed, 1);
+            }
+
+            inline void on_initialize()
+            {
+                add(tasks_initialized, 1);
+            }
+
+            inline void on_ready_pop()
+            {
+                add(ready_pops, 1);
+            }
+
+            inline void on_emplacement_pop()
+            {
+                add(emplacement_pops, 1);
+            }
+
+            inline void on_steal_ready(bool success)
+            {
+                add(steal_ready_attempts, 1);
+                if(success)
+                    add(steal_ready_successes, 1);
+            }
+
+            inline void on_steal_new(bool success)
+            {
+                add(steal_new_attempts, 1);
+                if(success)
+                    add(steal_new_successes, 1);
+            }
+
+            inline void on_free_worker_search(bool found)
+            {
+                add(free_worker_searches, 1);
+                if(!found)
+                    add(free_worker_misses, 1);
+            }
+
+            inline void on_bitfield_probe()
+            {
+                add(bitfield_probes, 1);
+            }
+
+            inline void on_claim_conflict()
+            {
+                add(claim_conflicts, 1);
+            }
+
+            //! called on the worker which was woken up
+            inline void on_wakeup()
+            {
+                wakeups_received.fetch_add(1, std::memory_order_relaxed);
+                if(current)
+                    add(current->wakeups_sent, 1);
+            }
+
+            inline void on_wait(CondVar::WaitStats const& wait)
+            {
+                add(spin_iterations, wait.spins);
+                if(wait.parked)
+                {
+                    add(parks, 1);
+                    add(parked_ns, wait.parked_ns);
+                }
+            }
+
+            //! counter values since the last `reset()`
+            inline void read(SchedulerStats& stats) const
+            {
+                read_totals(stats);
+                std::lock_guard<std::mutex> lock(baseline_mutex);
+                stats -= baseline;
+            }
+
+            //! start a new phase, may be called while the workers are running
+            inline void reset()
+            {
+                std::lock_guard<std::mutex> lock(baseline_mutex);
+                read_totals(baseline);
+            }
+
+        private:
+            //! only accessed by threads reading or resetting the counters, never by the worker
+            mutable std::mutex baseline_mutex;
+            SchedulerStats baseline;
+
+            inline void read_totals(SchedulerStats& stats) const
+            {
+                stats.tasks_executed = tasks_executed.load(std::memory_order_relaxed);
+                stats.tasks_initialized = tasks_initialized.load(std::memory_order_relaxed);
+                stats.ready_pops = ready_pops.load(std::memory_order_relaxed);
+                stats.emplacement_pops = emplacement_pops.load(std::memory_order_relaxed);
+                stats.steal_ready_attempts = steal_ready_attempts.load(std::memory_order_relaxed);
+                stats.steal_ready_successes = steal_ready_successes.load(std::memory_order_relaxed);
+                stats.steal_new_attempts = steal_new_attempts.load(std::memory_order_relaxed);
+                stats.steal_new_successes = steal_new_successes.load(std::memory_order_relaxed);
+                stats.free_worker_searches = free_worker_searches.load(std::memory_order_relaxed);
+                stats.free_worker_misses = free_worker_misses.load(std::memory_order_relaxed);
+                stats.bitfield_probes = bitfield_probes.load(std::memory_order_relaxed);
+                stats.claim_conflicts = claim_conflicts.load(std::memory_order_relaxed);
+                stats.wakeups_sent = wakeups_sent.load(std::memory_order_relaxed);
+                stats.wakeups_received = wakeups_received.load(std::memory_order_relaxed);
+                stats.spin_iterations = spin_iterations.load(std::memory_order_relaxed);
+                stats.parks = parks.load(std::memory_order_relaxed);
+                stats.parked_ns = parked_ns.load(std::memory_order_relaxed);
+            }
+#else
+            inline void on_execute()
+            {
+            }
+
+            inline void on_initialize()
+            {
+            }
+
+            inline void on_ready_pop()
+            {
+            }
+
+            inline void on_emplacement_pop()
+            {
+            }
+
+            inline void on_steal_ready(bool)
+            {
+            }
+
+            inline void on_steal_new(bool)
+            {
+            }
+
+            inline void on_free_worker_search(bool)
+            {
+            }
+
+            inline void on_bitfield_probe()
+            {
+            }
+
+            inline void on_claim_conflict()
+            {
+            }
+
+            inline void on_wakeup()
+            {
+            }
+
+            inline void on_wait(CondVar::WaitStats const&)
+            {
+            }
+
+            inline void read(SchedulerStats&) const
+            {
+            }
+
+            inline void reset()
+            {
+            }
+#endif
+        };
+
+    } // namespace scheduler
+} // namespace redGrapes
+
+template<>
+struct fmt::formatter<redGrapes::scheduler::SchedulerStats>
+{
+    constexpr auto parse(format_parse_context& ctx)
+    {
+        return ctx.begin();
+    }
+
+    template<typename FormatContext>
+    auto format(redGrapes::scheduler::SchedulerStats const& s, FormatContext& ctx) const
+    {
+        return fmt::format_to(
+            ctx.out(),
+            "{{ \"tasks_executed\" : {}, \"tasks_initialized\" : {}, \"ready_pops\" : {}, "
+            "\"emplacement_pops\" : {}, \"steal_ready_attempts\" : {}, \"steal_ready_successes\" : {}, "
+            "\"steal_new_attempts\" : {}, \"steal_new_successes\" : {}, \"free_worker_searches\" : {}, "
+            "\"free_worker_misses\" : {}, \"bitfield_probes\" : {}, \"claim_conflicts\" : {}, \"wakeups_sent\" : {}, "
+            "\"wakeups_received\" : {}, \"spin_iterations\" : {}, \"parks\" : {}, \"parked_ns\" : {} }}",
+            s.tasks_executed,
+            s.tasks_initialized,
+            s.ready_pops,
+            s.emplacement_pops,
+            s.steal_ready_attempts,
+            s.steal_ready_successes,
+            s.steal_new_attempts,
+            s.steal_new_successes,
+            s.free_worker_searches,
+            s.free_worker_misses,
+            s.bitfield_probes,
+            s.claim_conflicts,
+            s.wakeups_sent,
+            s.wakeups_received,
+            s.spin_iterations,
+            s.parks,
+            s.parked_ns);
+    }
+};
@@ -0,0 +1,86 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "redGrapes/sync/cv.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+/* number of unsuccessful polls at full frequency
+ * before a polling worker starts to back off
+ */
+#ifndef REDGRAPES_POLL_SPIN_COUNT
+#    define REDGRAPES_POLL_SPIN_COUNT 0x1000
+#endif
+
+/* upper limit for the sleep period (in microseconds)
+ * between two polls of a backed-off worker
+ */
+#ifndef REDGRAPES_POLL_BACKOFF_MAX_US
+#    define REDGRAPES_POLL_BACKOFF_MAX_US 1000
+#endif
+
+namespace redGrapes
+{
+
+    /* Adaptive backoff for threads which have to poll for external
+     * completions (e.g. MPI requests or CUDA events).
+     *
+     * While polls keep failing, the first `spin_count` calls to `pause()`
+     * return immediately, so the caller polls at full frequency.
+     * After that, the thread sleeps on its condition variable
+     * for exponentially growing periods up to `max_delay`.
+     * Since the sleep happens on the condition variable, any
+     * newly dispatched task interrupts it right away.
+     */
+    struct PollBackoff
+    {
+        unsigned const spin_count;
+        std::chrono::microseconds const max_delay;
+
+        PollBackoff(
+            unsigned spin_count = REDGRAPES_POLL_SPIN_COUNT,
+            std::chrono::microseconds max_delay = std::chrono::microseconds(REDGRAPES_POLL_BACKOFF_MAX_US))
+            : spin_count(spin_count)
+            , max_delay(max_delay)
+        {
+        }
+
+        //! called whenever polling made progress
+        inline void reset()
+        {
+            count = 0;
+            delay = std::chrono::microseconds(1);
+        }
+
+        /*! called after an unsuccessful poll
+         * @return true if the sleep was interrupted by a notification of `cv`
+         */
+        inline bool pause(CondVar& cv)
+        {
+            if(++count <= spin_count)
+                return false;
+
+            bool notified = cv.wait_for(delay);
+            delay = std::min(delay * 2, max_delay);
+            return notified;
+        }
+
+        //! period of the next sleep once spinning is over
+        inline std::chrono::microseconds current_delay() const
+        {
+            return delay;
+        }
+
+    private:
+        unsigned count = 0;
+        std::chrono::microseconds delay{1};
+    };
+
+} // namespace redGrapes
@@ -8,7 +8,11 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
 
 #ifndef REDGRAPES_CONDVAR_TIMEOUT
 #    define REDGRAPES_CONDVAR_TIMEOUT 0x20'0000
@@ -37,7 +41,18 @@ namespace redGrapes
 
         unsigned timeout;
 
-        CondVar() : CondVar(REDGRAPES_CONDVAR_TIMEOUT)
+        /* number of polls before a condition variable constructed without explicit timeout goes to sleep.
+         * Defaults to REDGRAPES_CONDVAR_TIMEOUT, but can be overridden by the environment variable
+         * of the same name, or by assigning to it before the runtime is initialized.
+         */
+        static inline unsigned default_timeout = []
+        {
+            if(char const* value = std::getenv("REDGRAPES_CONDVAR_TIMEOUT"))
+                return unsigned(std::strtoul(value, nullptr, 0));
+            return unsigned(REDGRAPES_CONDVAR_TIMEOUT);
+        }();
+
+        CondVar() : CondVar(default_timeout)
         {
         }
 
@@ -45,8 +60,22 @@ namespace redGrapes
         {
         }
 
-        void wait()
+        //! what happened during one call to `wait()`
+        struct WaitStats
         {
+            //! iterations spent polling before returning or parking
+            unsigned spins = 0;
+
+            //! true if the thread was put to sleep on the condition variable
+            bool parked = false;
+
+            //! nanoseconds spent sleeping on the condition variable
+            uint64_t parked_ns = 0;
+        };
+
+        WaitStats wait()
+        {
+            WaitStats stats;
             unsigned count = 0;
             while(should_wait.load(std::memory_order_acquire))
             {
@@ -57,13 +86,43 @@ namespace redGrapes
 
                     if(should_wait.load(std::memory_order_acquire))
                     {
-                        std::unique_lock<CVMutex> l(m);
-                        cv.wait(l, [this] { return !should_wait.load(std::memory_order_acquire); });
+                        auto begin = std::chrono::steady_clock::now();
+                        {
+                            std::unique_lock<CVMutex> l(m);
+                            cv.wait(l, [this] { return !should_wait.load(std::memory_order_acquire); });
+                        }
+                        stats.parked = true;
+                        stats.parked_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                              std::chrono::steady_clock::now() - begin)
+                                              .count();
                     }
                 }
             }
 
+            stats.spins = count;
             should_wait.store(true, std::memory_order_release);
+            return stats;
+        }
+
+        /* like wait(), but sleeps right away without spinning
+         * and gives up after `duration` if not notified.
+         *
+         * @return true if notified
+         */
+        template<typename Rep, typename Period>
+        bool wait_for(std::chrono::duration<Rep, Period> const& duration)
+        {
+            bool notified;
+            {
+                std::unique_lock<CVMutex> l(m);
+                notified
+                    = cv.wait_for(l, duration, [this] { return !should_wait.load(std::memory_order_acquire); });
+            }
+
+            if(notified)
+                should_wait.store(true, std::memory_order_release);
+
+            return notified;
         }
 
         bool notify()
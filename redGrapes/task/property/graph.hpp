@@ -151,6 +151,21 @@ namespace redGrapes
          */
         void delete_from_resources();
 
+        /*!
+         * take all resources which this task accesses commutatively, when its pre-event becomes ready.
+         * They are taken in the order of their ids. If one of them is held by another task,
+         * the task keeps the ones taken so far, is queued at that resource with an additional
+         * in-edge on its pre-event and false is returned. The owner hands the resource over when
+         * it finishes and notifies the pre-event, so the next call continues with the remaining ones.
+         */
+        bool try_lock_commutative();
+
+        /*!
+         * release the commutative resources of this task once it finished
+         * and hand each of them over to the first task waiting for it.
+         */
+        void unlock_commutative();
+
         template<typename PropertiesBuilder>
         struct Builder
         {
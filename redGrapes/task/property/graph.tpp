@@ -8,8 +8,13 @@
 #include "redGrapes/scheduler/event.hpp"
 #include "redGrapes/sync/spinlock.hpp"
 #include "redGrapes/task/property/graph.hpp"
+#include "redGrapes/task/property/timing.hpp"
+#include "redGrapes/util/graph_recorder.hpp"
 #include "redGrapes/util/trace.hpp"
 
+#include <algorithm>
+#include <vector>
+
 namespace redGrapes
 {
 
@@ -34,6 +39,7 @@ namespace redGrapes
     void GraphProperty<TTask>::init_graph()
     {
         TRACE_EVENT("Graph", "init_graph");
+        timing::stamp(*task, timing::Stage::Initialize);
         for(auto r = task->unique_resources.rbegin(); r != task->unique_resources.rend(); ++r)
         {
             if(r->user_entry != r->resource->users.rend())
@@ -86,6 +92,101 @@ namespace redGrapes
         }
     }
 
+    namespace detail
+    {
+        //! nearest ancestor of `user` which accesses `r` commutatively, it holds `r` while its children run
+        template<typename TTask, typename TResource>
+        TTask* commutative_ancestor(TTask* user, TResource const& r)
+        {
+            for(auto p = static_cast<TTask*>(user->space->parent); p != nullptr;
+                p = static_cast<TTask*>(p->space->parent))
+                for(auto ra = p->access_list.rbegin(); ra != p->access_list.rend(); ++ra)
+                    if(ra->is_commutative() && ra->get_resource().get() == r)
+                        return p;
+            return nullptr;
+        }
+
+        /* resources which `user` accesses commutatively, without duplicates
+         * and in a global order, so that tasks taking several of them cannot deadlock
+         */
+        template<typename TTask>
+        std::vector<ResourceBase*> commutative_resources(TTask* user)
+        {
+            std::vector<ResourceBase*> resources;
+            for(auto ra = user->access_list.rbegin(); ra != user->access_list.rend(); ++ra)
+                if(ra->is_commutative())
+                    resources.push_back(ra->get_resource().get());
+
+            std::sort(
+                resources.begin(),
+                resources.end(),
+                [](ResourceBase* a, ResourceBase* b) { return a->id < b->id || (a->id == b->id && a < b); });
+            resources.erase(std::unique(resources.begin(), resources.end()), resources.end());
+            return resources;
+        }
+    } // namespace detail
+
+    template<typename TTask>
+    bool GraphProperty<TTask>::try_lock_commutative()
+    {
+        TRACE_EVENT("Graph", "try_lock_commutative");
+        for(ResourceBase* r : detail::commutative_resources(task))
+        {
+            std::unique_lock<SpinLock> lock(r->commute_mutex);
+
+            // children take over the resource from their parent and hand it back when they finish
+            if(r->commute_owner == task)
+                continue;
+            if(r->commute_owner == nullptr || r->commute_owner == detail::commutative_ancestor(task, r))
+                r->commute_owner = task;
+            else
+            {
+                /* keep the resources taken so far and queue up,
+                 * the owner hands this one over and notifies the pre-event again
+                 */
+                pre_event.up();
+                r->commute_waiters.push_back(task);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<typename TTask>
+    void GraphProperty<TTask>::unlock_commutative()
+    {
+        TRACE_EVENT("Graph", "unlock_commutative");
+        for(ResourceBase* r : detail::commutative_resources(task))
+        {
+            TTask* next = nullptr;
+            {
+                std::unique_lock<SpinLock> lock(r->commute_mutex);
+                if(r->commute_owner != task)
+                    continue;
+
+                r->commute_owner = detail::commutative_ancestor(task, r);
+
+                /* hand the resource over to the first waiter which may take it,
+                 * while the ancestor holds it again this is one of its children
+                 */
+                for(auto it = r->commute_waiters.begin(); it != r->commute_waiters.end(); ++it)
+                {
+                    auto waiter = static_cast<TTask*>(*it);
+                    if(r->commute_owner == nullptr || r->commute_owner == detail::commutative_ancestor(waiter, r))
+                    {
+                        next = waiter;
+                        r->commute_waiters.erase(it);
+                        r->commute_owner = next;
+                        break;
+                    }
+                }
+            }
+
+            if(next)
+                next->get_pre_event().notify();
+        }
+    }
+
     template<typename TTask>
     void GraphProperty<TTask>::add_dependency(TTask& preceding_task)
     {
@@ -93,8 +194,16 @@ namespace redGrapes
                                    ? preceding_task->get_pre_event()
                                    : preceding_task->get_post_event();
 
-        if(!preceding_event->is_reached())
+        bool const reached = preceding_event->is_reached();
+        if(!reached)
             preceding_event->add_follower(get_pre_event());
+
+        if(graph_recorder::is_enabled())
+            graph_recorder::record_edge(graph_recorder::Edge{
+                preceding_task.task_id,
+                task->task_id,
+                preceding_event.tag == scheduler::T_EVT_PRE,
+                reached});
     }
 
     template<typename TTask>
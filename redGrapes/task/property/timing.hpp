@@ -0,0 +1,355 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * @file redGrapes/task/property/timing.hpp
+ */
+
+#pragma once
+
+#include "redGrapes/TaskFreeCtx.hpp"
+#include "redGrapes/util/tsc_clock.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace redGrapes
+{
+    namespace timing
+    {
+
+        /* histogram of durations with logarithmic buckets,
+         * bucket `i` counts durations in [2^i, 2^(i+1)) nanoseconds
+         */
+        struct Histogram
+        {
+            static constexpr unsigned n_buckets = 64;
+
+            std::array<uint64_t, n_buckets> buckets{};
+            uint64_t count = 0;
+            uint64_t sum_ns = 0;
+            uint64_t max_ns = 0;
+
+            void record(uint64_t ns)
+            {
+                ++buckets[ns ? std::bit_width(ns) - 1 : 0];
+                ++count;
+                sum_ns += ns;
+                max_ns = std::max(max_ns, ns);
+            }
+
+            uint64_t mean_ns() const
+            {
+                return count ? sum_ns / count : 0;
+            }
+
+            /* upper bound of the duration below which a fraction `q` of all samples lie,
+             * exact up to a factor of two
+             */
+            uint64_t quantile_ns(double q) const
+            {
+                uint64_t const rank = (uint64_t) (q * count);
+                uint64_t seen = 0;
+                for(unsigned i = 0; i < n_buckets; ++i)
+                {
+                    seen += buckets[i];
+                    if(seen > rank)
+                        return std::min(max_ns, i + 1 < n_buckets ? (uint64_t(1) << (i + 1)) - 1 : UINT64_MAX);
+                }
+                return max_ns;
+            }
+
+            Histogram& operator+=(Histogram const& other)
+            {
+                for(unsigned i = 0; i < n_buckets; ++i)
+                    buckets[i] += other.buckets[i];
+                count += other.count;
+                sum_ns += other.sum_ns;
+                max_ns = std::max(max_ns, other.max_ns);
+                return *this;
+            }
+        };
+
+        //! latencies of all finished tasks with the same label
+        struct Summary
+        {
+            //! from submission until the task is ready, i.e. all dependencies are satisfied
+            Histogram queue_wait;
+
+            //! from ready until the first execution starts
+            Histogram ready_to_start;
+
+            //! from the first start until the last execution finished
+            Histogram run;
+
+            Summary& operator+=(Summary const& other)
+            {
+                queue_wait += other.queue_wait;
+                ready_to_start += other.ready_to_start;
+                run += other.run;
+                return *this;
+            }
+        };
+
+        //! summaries collected by one thread
+        struct ThreadSummaries
+        {
+            std::mutex mutex;
+            std::unordered_map<std::string, Summary> by_label;
+        };
+
+        struct Registry
+        {
+            static inline std::mutex mutex;
+            static inline std::vector<std::shared_ptr<ThreadSummaries>> threads;
+
+            static inline thread_local std::shared_ptr<ThreadSummaries> local;
+
+            static ThreadSummaries& local_summaries()
+            {
+                if(!local)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    local = std::make_shared<ThreadSummaries>();
+                    threads.push_back(local);
+                }
+                return *local;
+            }
+        };
+
+        /*! merge the summaries of all threads
+         *
+         * @return one summary per task label,
+         *         tasks without a `LabelProperty` are summarized under the empty label
+         */
+        inline std::map<std::string, Summary> summaries()
+        {
+            std::map<std::string, Summary> merged;
+
+            std::lock_guard<std::mutex> lock(Registry::mutex);
+            for(auto& thread : Registry::threads)
+            {
+                std::lock_guard<std::mutex> thread_lock(thread->mutex);
+                for(auto const& [label, summary] : thread->by_label)
+                    merged[label] += summary;
+            }
+            return merged;
+        }
+
+        //! drop all summaries collected so far, e.g. at the begin of a new phase
+        inline void reset()
+        {
+            std::lock_guard<std::mutex> lock(Registry::mutex);
+            for(auto& thread : Registry::threads)
+            {
+                std::lock_guard<std::mutex> thread_lock(thread->mutex);
+                thread->by_label.clear();
+            }
+        }
+
+        enum class Stage
+        {
+            Submit,
+            Initialize,
+            Ready,
+            Start,
+            Finish,
+            Free
+        };
+
+    } // namespace timing
+
+    /* Stamps each stage in the life of a task with `TscClock`.
+     * When the task is freed, its latencies are added to
+     * the summary of its label (see `timing::summaries()`).
+     *
+     * Tasks which are paused on an event keep the time of their first
+     * readiness and first start, and the time of their last finish.
+     */
+    struct TimingProperty
+    {
+        uint64_t created;
+        uint64_t submitted = 0;
+        uint64_t initialized = 0;
+        uint64_t ready = 0;
+        uint64_t started = 0;
+        uint64_t finished = 0;
+        uint64_t freed = 0;
+
+        // Params workerId and scope_depth
+        TimingProperty(WorkerId, unsigned) : created(TscClock::now())
+        {
+        }
+
+        void stamp(timing::Stage stage, std::string const* label)
+        {
+            uint64_t const now = TscClock::now();
+            switch(stage)
+            {
+            case timing::Stage::Submit:
+                submitted = now;
+                break;
+            case timing::Stage::Initialize:
+                if(!initialized)
+                    initialized = now;
+                break;
+            case timing::Stage::Ready:
+                if(!ready)
+                    ready = now;
+                break;
+            case timing::Stage::Start:
+                if(!started)
+                    started = now;
+                break;
+            case timing::Stage::Finish:
+                finished = now;
+                break;
+            case timing::Stage::Free:
+                freed = now;
+                summarize(label ? *label : std::string());
+                break;
+            }
+        }
+
+        template<typename TaskBuilder>
+        struct Builder
+        {
+            Builder(TaskBuilder&)
+            {
+            }
+        };
+
+        struct Patch
+        {
+            template<typename PatchBuilder>
+            struct Builder
+            {
+                Builder(PatchBuilder&)
+                {
+                }
+            };
+        };
+
+        void apply_patch(Patch const&)
+        {
+        }
+
+    private:
+        void summarize(std::string const& label)
+        {
+            if(!submitted || !ready || !started)
+                return;
+
+            timing::ThreadSummaries& summaries = timing::Registry::local_summaries();
+            std::lock_guard<std::mutex> lock(summaries.mutex);
+
+            timing::Summary& s = summaries.by_label[label];
+            s.queue_wait.record(TscClock::to_ns(ready - std::min(ready, submitted)));
+            s.ready_to_start.record(TscClock::to_ns(started - std::min(started, ready)));
+            s.run.record(TscClock::to_ns(finished - std::min(finished, started)));
+        }
+    };
+
+    namespace timing
+    {
+
+        /* stamp a stage of `task`,
+         * does nothing if the task type has no `TimingProperty`
+         */
+        template<typename TTask>
+        inline void stamp(TTask& task, Stage stage)
+        {
+            if constexpr(std::is_base_of_v<TimingProperty, TTask>)
+            {
+                std::string const* label = nullptr;
+                if constexpr(requires { task.label; })
+                    label = &task.label;
+
+                static_cast<TimingProperty&>(task).stamp(stage, label);
+            }
+        }
+
+    } // namespace timing
+
+} // namespace redGrapes
+
+template<>
+struct fmt::formatter<redGrapes::TimingProperty>
+{
+    constexpr auto parse(format_parse_context& ctx)
+    {
+        return ctx.begin();
+    }
+
+    template<typename FormatContext>
+    auto format(redGrapes::TimingProperty const& t, FormatContext& ctx) const
+    {
+        return fmt::format_to(
+            ctx.out(),
+            "\"timing\" : {{ \"created\" : {}, \"submitted\" : {}, \"initialized\" : {}, \"ready\" : {}, "
+            "\"started\" : {}, \"finished\" : {} }}",
+            t.created,
+            t.submitted,
+            t.initialized,
+            t.ready,
+            t.started,
+            t.finished);
+    }
+};
+
+template<>
+struct fmt::formatter<redGrapes::timing::Histogram>
+{
+    constexpr auto parse(format_parse_context& ctx)
+    {
+        return ctx.begin();
+    }
+
+    template<typename FormatContext>
+    auto format(redGrapes::timing::Histogram const& h, FormatContext& ctx) const
+    {
+        return fmt::format_to(
+            ctx.out(),
+            "{{ \"count\" : {}, \"mean_ns\" : {}, \"p50_ns\" : {}, \"p99_ns\" : {}, \"max_ns\" : {} }}",
+            h.count,
+            h.mean_ns(),
+            h.quantile_ns(0.5),
+            h.quantile_ns(0.99),
+            h.max_ns);
+    }
+};
+
+template<>
+struct fmt::formatter<redGrapes::timing::Summary>
+{
+    constexpr auto parse(format_parse_context& ctx)
+    {
+        return ctx.begin();
+    }
+
+    template<typename FormatContext>
+    auto format(redGrapes::timing::Summary const& s, FormatContext& ctx) const
+    {
+        return fmt::format_to(
+            ctx.out(),
+            "{{ \"queue_wait\" : {}, \"ready_to_start\" : {}, \"run\" : {} }}",
+            s.queue_wait,
+            s.ready_to_start,
+            s.run);
+    }
+};
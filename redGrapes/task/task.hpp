@@ -13,6 +13,7 @@
 #include "redGrapes/task/property/resource.hpp"
 #include "redGrapes/task/task_base.hpp"
 
+#include <cstddef>
 #include <cstdint>
 #include <type_traits>
 
@@ -60,6 +61,12 @@ namespace redGrapes
         {
             return nullptr;
         }
+
+        //! number of bytes allocated for the most derived task object
+        virtual size_t get_alloc_size() const
+        {
+            return sizeof(Task);
+        }
     };
 
     // TODO: fuse ResultTask and FunTask into one template
@@ -134,6 +141,11 @@ namespace redGrapes
         {
             return (*this->impl)();
         }
+
+        size_t get_alloc_size() const final
+        {
+            return sizeof(FunTask);
+        }
     };
 
 } // namespace redGrapes
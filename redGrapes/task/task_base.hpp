@@ -8,6 +8,7 @@
 #pragma once
 
 #include "redGrapes/scheduler/event.hpp"
+#include "redGrapes/task/property/timing.hpp"
 
 #include <boost/context/continuation.hpp>
 
@@ -34,6 +35,8 @@ namespace redGrapes
 
         std::optional<scheduler::EventPtr<TTask>> operator()()
         {
+            timing::stamp(static_cast<TTask&>(*this), timing::Stage::Start);
+
             if(enable_stack_switching)
             {
                 if(!resume_cont)
@@ -65,6 +68,7 @@ namespace redGrapes
                 this->run();
             }
 
+            timing::stamp(static_cast<TTask&>(*this), timing::Stage::Finish);
             return event;
         }
 
@@ -7,9 +7,11 @@
 #pragma once
 
 #include "redGrapes/task/future.hpp"
+#include "redGrapes/task/property/timing.hpp"
 #include "redGrapes/task/task.hpp"
 #include "redGrapes/task/task_space.hpp"
 #include "redGrapes/util/bind_args.hpp"
+#include "redGrapes/util/graph_recorder.hpp"
 
 #include <spdlog/spdlog.h>
 
@@ -103,7 +105,9 @@ namespace redGrapes
             task = nullptr;
 
             SPDLOG_TRACE("submit task {}", (typename TTask::TaskProperties const&) *t);
+            timing::stamp(*t, timing::Stage::Submit);
             space->submit(t);
+            graph_recorder::record_task(*t);
             t->scheduler_p->emplace_task(*t);
 
             return Future<Result, TTask>(*t);
@@ -8,9 +8,11 @@
 #pragma once
 
 #include "redGrapes/TaskFreeCtx.hpp"
+#include "redGrapes/memory/allocator.hpp"
 #include "redGrapes/memory/block.hpp"
 #include "redGrapes/resource/resource_user.hpp"
 #include "redGrapes/task/property/id.hpp"
+#include "redGrapes/task/property/timing.hpp"
 #include "redGrapes/util/trace.hpp"
 
 #include <atomic>
@@ -75,11 +77,11 @@ namespace redGrapes
             TaskID count = task_count.fetch_sub(1) - 1;
 
             WorkerId worker_id = task->worker_id;
+            size_t alloc_size = task->get_alloc_size();
+            timing::stamp(*task, timing::Stage::Free);
             task->~TTask();
 
-            // FIXME: len of the Block is not correct since FunTask object is bigger than sizeof(Task)
-            TaskFreeCtx::worker_alloc_pool.get_alloc(worker_id).deallocate(
-                memory::Block{(uintptr_t) task, sizeof(TTask)});
+            memory::RecyclingAllocator(worker_id).deallocate(memory::Block{(uintptr_t) task, alloc_size});
 
             // TODO: implement this using post-event of root-task?
             //  - event already has in_edge count
@@ -16,6 +16,7 @@
 #include <spdlog/spdlog.h>
 
 #include <atomic>
+#include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -35,6 +36,10 @@ namespace redGrapes
          * contiguous block containing list-metadata, the chunk-control-object
          * (`ChunkData`) and freely usable data.
          *
+         * If a `chunk_alignment` is given, every chunk starts at an address
+         * aligned to it, so the chunk containing some address can be found
+         * in constant time with `find_controlblock()`.
+         *
          * @tparam Item element type
          * @tparam Allocator must satisfy `Allocator` concept
          */
@@ -50,6 +55,11 @@ namespace redGrapes
 
                 ItemControlBlock(memory::Block blk) : deleted(false), item_data_ptr(blk.ptr)
                 {
+                    /* the last word of the reserved control block region
+                     * points back to this object (see `find_controlblock()`)
+                     */
+                    *((ItemControlBlock**) (blk.ptr - sizeof(ItemControlBlock*))) = this;
+
                     /* put Item at front and initialize it
                      * with the remaining memory region
                      */
@@ -92,6 +102,7 @@ namespace redGrapes
             Allocator alloc;
             std::shared_ptr<ItemControlBlock> head;
             size_t const chunk_capacity;
+            size_t const chunk_alignment;
 
             /* keeps a single, predefined pointer
              * and frees it on deallocate.
@@ -105,14 +116,38 @@ namespace redGrapes
                 Allocator alloc;
                 T* ptr;
 
-                StaticAlloc(Allocator alloc, size_t n_bytes) : alloc(alloc), ptr((T*) alloc.allocate(n_bytes))
+                //! the underlying allocation, which might be larger than requested for alignment
+                memory::Block raw_blk;
+
+                StaticAlloc(Allocator alloc, size_t n_bytes, size_t alignment = 0)
+                    : alloc(alloc)
+                    , raw_blk(allocate_raw(alloc, n_bytes, alignment))
                 {
+                    uintptr_t addr = raw_blk.ptr;
+                    if(alignment && raw_blk)
+                        addr = (addr + alignment - 1) & ~(uintptr_t) (alignment - 1);
+                    ptr = (T*) addr;
+
                     SPDLOG_TRACE(" object: {} , bytes : {}", util::type_name<Item>(), n_bytes);
                 }
 
+                /* allocators which can provide aligned memory themselves
+                 * (e.g. by carving it out of a larger region) are asked to do so,
+                 * otherwise the request is padded by the alignment.
+                 */
+                static memory::Block allocate_raw(Allocator& alloc, size_t n_bytes, size_t alignment)
+                {
+                    if constexpr(requires { alloc.allocate_aligned(n_bytes, alignment); })
+                        if(alignment)
+                            return alloc.allocate_aligned(n_bytes, alignment);
+
+                    return alloc.allocate(alignment ? n_bytes + alignment : n_bytes);
+                }
+
                 template<typename U>
                 constexpr StaticAlloc(StaticAlloc<U> const& other) noexcept : alloc(other.alloc)
                                                                             , ptr((T*) other.ptr)
+                                                                            , raw_blk(other.raw_blk)
                 {
                 }
 
@@ -121,18 +156,29 @@ namespace redGrapes
                     return ptr;
                 }
 
+                /* always release the whole chunk,
+                 * not only the part requested by allocate_shared
+                 */
                 void deallocate(T* p, std::size_t n) noexcept
                 {
-                    alloc.deallocate(Block{.ptr = (uintptr_t) p, .len = sizeof(T) * n});
+                    alloc.deallocate(raw_blk);
                 }
             };
 
         public:
-            AtomicList(Allocator&& alloc, size_t chunk_capacity)
+            /*
+             * @param chunk_capacity number of bytes available for each Item
+             * @param chunk_alignment if nonzero, chunks are aligned to this power of two,
+             *        which must not be smaller than `get_chunk_allocsize()`
+             */
+            AtomicList(Allocator&& alloc, size_t chunk_capacity, size_t chunk_alignment = 0)
                 : alloc(alloc)
                 , head(nullptr)
                 , chunk_capacity(chunk_capacity)
+                , chunk_alignment(chunk_alignment)
             {
+                assert((chunk_alignment & (chunk_alignment - 1)) == 0);
+                assert(chunk_alignment == 0 || get_chunk_allocsize() <= chunk_alignment);
             }
 
             static constexpr size_t get_controlblock_size()
@@ -170,12 +216,12 @@ namespace redGrapes
                  * but reserved by StaticAlloc.
                  * This works because shared_ptr control block lies at lower address.
                  */
-                StaticAlloc<void> chunk_alloc(this->alloc, get_chunk_allocsize());
+                StaticAlloc<void> chunk_alloc(this->alloc, get_chunk_allocsize(), chunk_alignment);
 
                 // this block will contain the Item-data of ItemControlBlock
                 memory::Block blk{
                     .ptr = (uintptr_t) chunk_alloc.ptr + get_controlblock_size(),
-                    .len = chunk_capacity - get_controlblock_size()};
+                    .len = chunk_capacity};
 
                 return append_item(std::allocate_shared<ItemControlBlock>(chunk_alloc, blk));
             }
@@ -187,12 +233,12 @@ namespace redGrapes
             bool try_allocate_first_item()
             {
                 TRACE_EVENT("Allocator", "AtomicList::allocate_first_item()");
-                StaticAlloc<void> chunk_alloc(this->alloc, get_chunk_allocsize());
+                StaticAlloc<void> chunk_alloc(this->alloc, get_chunk_allocsize(), chunk_alignment);
 
                 // this block will contain the Item-data of ItemControlBlock
                 memory::Block blk{
                     .ptr = (uintptr_t) chunk_alloc.ptr + get_controlblock_size(),
-                    .len = chunk_capacity - get_controlblock_size()};
+                    .len = chunk_capacity};
 
                 auto sharedChunk = std::allocate_shared<ItemControlBlock>(chunk_alloc, blk);
                 return try_append_first_item(std::move(sharedChunk));
@@ -285,6 +331,32 @@ namespace redGrapes
                 pos.erase();
             }
 
+            void erase(ItemControlBlock* chunk)
+            {
+                chunk->erase();
+            }
+
+            /* get the control block of the chunk which contains `addr`
+             * without iterating the list.
+             * Requires `chunk_alignment` to be set and the chunk to be alive.
+             */
+            ItemControlBlock* find_controlblock(uintptr_t addr) const
+            {
+                assert(chunk_alignment);
+                uintptr_t chunk_base = addr & ~(uintptr_t) (chunk_alignment - 1);
+                return *((ItemControlBlock**) (chunk_base + get_controlblock_size() - sizeof(ItemControlBlock*)));
+            }
+
+            /* iterate the whole list once, so that all chunks which
+             * are flagged as erased are unlinked and can be freed
+             */
+            void unlink_erased()
+            {
+                TRACE_EVENT("Allocator", "AtomicList::unlink_erased()");
+                for(auto it = rbegin(); it != rend(); ++it)
+                    ;
+            }
+
             /* atomically appends a floating chunk to this list
              * and returns the previous head to which the new_head
              * is now linked.
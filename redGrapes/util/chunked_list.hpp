@@ -18,6 +18,7 @@
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <cstdint>
@@ -159,7 +160,8 @@ namespace redGrapes
                 assert(iter_offset != 0);
                 assert(refcount == 0);
 
-                storage.value = value;
+                // storage is uninitialized, so construct instead of assigning
+                new(&storage.value) T(value);
 
                 /* here, item.value is now fully initalized,
                  * so allow iterators to access this item now.
@@ -255,7 +257,9 @@ namespace redGrapes
 
             ~Chunk()
             {
-                for(Item* item = first_item; item < (this->next_item); item++)
+                // `next_item` overshoots the end of the chunk once a push overflowed it
+                Item* end = std::min(this->next_item.load(), this->first_item + T_chunk_size);
+                for(Item* item = first_item; item < end; item++)
                     item->~Item();
             }
 
@@ -0,0 +1,390 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "redGrapes/resource/resource_user.hpp"
+#include "redGrapes/util/tracer.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/* if enabled, the task-graph recorder is compiled in.
+ * It still has to be switched on at runtime with `graph_recorder::enable()`
+ * or by setting the environment variable `REDGRAPES_TASK_GRAPH` to an output file.
+ */
+#ifndef REDGRAPES_GRAPH_RECORDER
+#    define REDGRAPES_GRAPH_RECORDER 1
+#endif
+
+namespace redGrapes
+{
+    /* Records the precedence graph which is actually built at runtime:
+     * every submitted task with its label and resource accesses,
+     * every dependency edge inserted by `GraphProperty::add_dependency()`
+     * and the time span in which each task was executed.
+     * Tasks are inserted into the graph lazily by the workers, so predecessors
+     * which already finished at that point do not show up as edges.
+     *
+     * The graph can be exported as DOT or as JSON for post-mortem
+     * critical-path and parallelism analysis.
+     * Timestamps use the same clock as the tracer, so both exports can be correlated.
+     *
+     * Unlike the tracer, nothing is overwritten, so the memory used
+     * grows with the number of tasks while recording is enabled.
+     */
+    namespace graph_recorder
+    {
+
+        struct Node
+        {
+            uint64_t id;
+            std::optional<uint64_t> parent;
+            std::string label;
+
+            //! JSON list of the resource accesses
+            std::string resources;
+
+            //! nanoseconds since the tracer epoch
+            uint64_t submitted;
+        };
+
+        struct Edge
+        {
+            uint64_t from;
+            uint64_t to;
+
+            //! `to` waits for the pre-event of `from` instead of its post-event
+            bool pre_event;
+
+            //! the preceding event was already reached, so no wait was inserted
+            bool reached;
+        };
+
+        struct Span
+        {
+            uint64_t id;
+            uint64_t begin;
+            uint64_t end;
+            unsigned worker;
+        };
+
+        //! records of one thread, written only by its owner
+        struct ThreadLog
+        {
+            std::mutex mutex;
+            std::vector<Node> nodes;
+            std::vector<Edge> edges;
+            std::vector<Span> spans;
+        };
+
+        struct Recorder
+        {
+            static inline std::atomic<bool> enabled{false};
+
+            static inline std::mutex mutex;
+            static inline std::vector<std::shared_ptr<ThreadLog>> logs;
+
+            static inline thread_local std::shared_ptr<ThreadLog> thread_log;
+
+            //! log of the calling thread, registered on first use
+            static ThreadLog& local_log()
+            {
+                if(!thread_log)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    thread_log = std::make_shared<ThreadLog>();
+                    logs.push_back(thread_log);
+                }
+                return *thread_log;
+            }
+        };
+
+        inline void enable()
+        {
+            Recorder::enabled.store(true, std::memory_order_release);
+        }
+
+        inline void disable()
+        {
+            Recorder::enabled.store(false, std::memory_order_release);
+        }
+
+        inline bool is_enabled()
+        {
+#if REDGRAPES_GRAPH_RECORDER
+            return Recorder::enabled.load(std::memory_order_relaxed);
+#else
+            return false;
+#endif
+        }
+
+        inline uint64_t now()
+        {
+            return tracer::Tracer::now();
+        }
+
+        inline void record_node(Node node)
+        {
+            ThreadLog& log = Recorder::local_log();
+            std::lock_guard<std::mutex> lock(log.mutex);
+            log.nodes.push_back(std::move(node));
+        }
+
+        inline void record_edge(Edge edge)
+        {
+            ThreadLog& log = Recorder::local_log();
+            std::lock_guard<std::mutex> lock(log.mutex);
+            log.edges.push_back(edge);
+        }
+
+        inline void record_span(Span span)
+        {
+            ThreadLog& log = Recorder::local_log();
+            std::lock_guard<std::mutex> lock(log.mutex);
+            log.spans.push_back(span);
+        }
+
+        /* record a submitted task.
+         * Only has an effect if the recorder is enabled.
+         */
+        template<typename TTask>
+        void record_task(TTask const& task)
+        {
+#if REDGRAPES_GRAPH_RECORDER
+            if(!is_enabled())
+                return;
+
+            Node node{task.task_id, std::nullopt, "", fmt::format("{}", (ResourceUser const&) task), now()};
+            if(task.space->parent)
+                node.parent = static_cast<TTask const*>(task.space->parent)->task_id;
+            if constexpr(requires { task.label; })
+                node.label = task.label;
+
+            record_node(std::move(node));
+#endif
+        }
+
+        //! @return start timestamp to pass to `end_span()`, or zero if the recorder is disabled
+        inline uint64_t begin_span()
+        {
+            return is_enabled() ? now() : 0;
+        }
+
+        //! record that `worker` executed task `id` since `begin`
+        inline void end_span(uint64_t id, uint64_t begin, unsigned worker)
+        {
+            if(begin != 0 && is_enabled())
+                record_span(Span{id, begin, now(), worker});
+        }
+
+        //! drop all records collected so far
+        inline void clear()
+        {
+            std::lock_guard<std::mutex> lock(Recorder::mutex);
+            for(auto& log : Recorder::logs)
+            {
+                std::lock_guard<std::mutex> log_lock(log->mutex);
+                log->nodes.clear();
+                log->edges.clear();
+                log->spans.clear();
+            }
+        }
+
+        //! merged view of all thread logs
+        struct Graph
+        {
+            struct Task
+            {
+                Node node;
+
+                //! first start and last end of execution, tasks may be resumed several times
+                std::optional<Span> span;
+            };
+
+            std::map<uint64_t, Task> tasks;
+            std::vector<Edge> edges;
+        };
+
+        inline Graph collect()
+        {
+            Graph graph;
+
+            std::lock_guard<std::mutex> lock(Recorder::mutex);
+            for(auto& log : Recorder::logs)
+            {
+                std::lock_guard<std::mutex> log_lock(log->mutex);
+
+                for(Node const& node : log->nodes)
+                    graph.tasks[node.id].node = node;
+
+                graph.edges.insert(graph.edges.end(), log->edges.begin(), log->edges.end());
+            }
+
+            for(auto& log : Recorder::logs)
+            {
+                std::lock_guard<std::mutex> log_lock(log->mutex);
+                for(Span const& s : log->spans)
+                {
+                    auto it = graph.tasks.find(s.id);
+                    if(it == graph.tasks.end())
+                        continue;
+
+                    std::optional<Span>& span = it->second.span;
+                    if(!span)
+                        span = s;
+                    else
+                    {
+                        if(s.begin < span->begin)
+                        {
+                            span->begin = s.begin;
+                            span->worker = s.worker;
+                        }
+                        span->end = std::max(span->end, s.end);
+                    }
+                }
+            }
+
+            return graph;
+        }
+
+        //! escape a string for a quoted JSON or DOT string
+        inline std::string escape(std::string const& s)
+        {
+            std::string out;
+            out.reserve(s.size());
+            for(char c : s)
+            {
+                if(c == '"' || c == '\\')
+                    out += '\\';
+                if(c == '\n')
+                    out += "\\n";
+                else
+                    out += c;
+            }
+            return out;
+        }
+
+        /* write the recorded graph as JSON:
+         * `{"tasks": [...], "edges": [...]}`, where each task carries
+         * its id, parent, label, resources and timestamps in nanoseconds.
+         */
+        inline void write_json(std::ostream& out)
+        {
+            Graph const graph = collect();
+
+            out << "{\"tasks\":[";
+            bool first = true;
+            for(auto const& [id, task] : graph.tasks)
+            {
+                out << (first ? "\n" : ",\n");
+                first = false;
+
+                Node const& n = task.node;
+                out << fmt::format(
+                    R"({{"id":{},"parent":{},"label":"{}","resources":{},"submitted":{})",
+                    id,
+                    n.parent ? fmt::format("{}", *n.parent) : "null",
+                    escape(n.label),
+                    n.resources.empty() ? "[]" : n.resources,
+                    n.submitted);
+
+                if(task.span)
+                    out << fmt::format(
+                        R"(,"start":{},"end":{},"worker":{})",
+                        task.span->begin,
+                        task.span->end,
+                        task.span->worker);
+                out << "}";
+            }
+
+            out << "\n],\"edges\":[";
+            first = true;
+            for(Edge const& e : graph.edges)
+            {
+                out << (first ? "\n" : ",\n");
+                first = false;
+                out << fmt::format(
+                    R"({{"from":{},"to":{},"event":"{}","reached":{}}})",
+                    e.from,
+                    e.to,
+                    e.pre_event ? "pre" : "post",
+                    e.reached);
+            }
+            out << "\n]}\n";
+        }
+
+        /* write the recorded graph in the DOT language.
+         * Dependencies which were already satisfied at insertion are dashed,
+         * the edges from parent tasks are dotted.
+         */
+        inline void write_dot(std::ostream& out)
+        {
+            Graph const graph = collect();
+
+            out << "digraph redGrapes {\n";
+            for(auto const& [id, task] : graph.tasks)
+            {
+                std::string label = escape(task.node.label.empty() ? fmt::format("task {}", id) : task.node.label);
+                if(task.span)
+                    label += fmt::format("\\n{:.3f} us", (task.span->end - task.span->begin) / 1000.0);
+
+                out << fmt::format(
+                    "  t{} [label=\"{}\", id={}, submitted={}",
+                    id,
+                    label,
+                    id,
+                    task.node.submitted);
+                if(task.span)
+                    out << fmt::format(
+                        ", start={}, end={}, worker={}",
+                        task.span->begin,
+                        task.span->end,
+                        task.span->worker);
+                out << "];\n";
+
+                if(task.node.parent)
+                    out << fmt::format("  t{} -> t{} [style=dotted];\n", *task.node.parent, id);
+            }
+
+            for(Edge const& e : graph.edges)
+                out << fmt::format("  t{} -> t{}{};\n", e.from, e.to, e.reached ? " [style=dashed]" : "");
+
+            out << "}\n";
+        }
+
+        /* write the graph to a file,
+         * in DOT if the path ends with `.dot` and as JSON otherwise.
+         * @return false if the file could not be written
+         */
+        inline bool write(std::string const& path)
+        {
+            std::ofstream out(path);
+            if(!out)
+                return false;
+
+            if(path.size() >= 4 && path.compare(path.size() - 4, 4, ".dot") == 0)
+                write_dot(out);
+            else
+                write_json(out);
+
+            return (bool) out;
+        }
+
+    } // namespace graph_recorder
+} // namespace redGrapes
@@ -0,0 +1,379 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "redGrapes/util/tracer.hpp"
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* if enabled, workers can read hardware performance counters
+ * around every task. Reading them still has to be switched on at runtime
+ * with `perf_counters::enable()` or by setting the environment variable
+ * `REDGRAPES_PERF_COUNTERS`.
+ */
+#ifndef REDGRAPES_PERF_COUNTERS
+#    if defined(__linux__)
+#        define REDGRAPES_PERF_COUNTERS 1
+#    else
+#        define REDGRAPES_PERF_COUNTERS 0
+#    endif
+#endif
+
+#if REDGRAPES_PERF_COUNTERS
+#    include <linux/perf_event.h>
+#    include <sys/ioctl.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
+namespace redGrapes
+{
+    /* Attributes hardware performance counters to tasks.
+     *
+     * Each worker thread opens one group of per-thread counters with
+     * `perf_event_open` on first use and reads it with a single syscall
+     * before and after every task. The deltas are summed up per task label
+     * and recorded into the tracer, where they show up as arguments of the task slice.
+     *
+     * Counters which are not supported by the system (e.g. inside virtual
+     * machines or with a restrictive `perf_event_paranoid`) read as zero.
+     */
+    namespace perf_counters
+    {
+
+        struct Counts
+        {
+            uint64_t cycles = 0;
+            uint64_t instructions = 0;
+            uint64_t llc_misses = 0;
+            uint64_t context_switches = 0;
+
+            Counts& operator+=(Counts const& other)
+            {
+                cycles += other.cycles;
+                instructions += other.instructions;
+                llc_misses += other.llc_misses;
+                context_switches += other.context_switches;
+                return *this;
+            }
+
+            Counts operator-(Counts const& other) const
+            {
+                return Counts{
+                    cycles - other.cycles,
+                    instructions - other.instructions,
+                    llc_misses - other.llc_misses,
+                    context_switches - other.context_switches};
+            }
+        };
+
+        //! counters accumulated over all tasks with the same label
+        struct Summary
+        {
+            uint64_t tasks = 0;
+            Counts counts;
+
+            //! instructions per cycle, low values hint at memory-bound tasks
+            double ipc() const
+            {
+                return counts.cycles ? double(counts.instructions) / counts.cycles : 0.0;
+            }
+
+            Summary& operator+=(Summary const& other)
+            {
+                tasks += other.tasks;
+                counts += other.counts;
+                return *this;
+            }
+        };
+
+        //! one group of counters of the calling thread
+        struct EventGroup
+        {
+            static constexpr unsigned n_events = 4;
+
+            //! index of each event in `fds`
+            enum Event : unsigned
+            {
+                cycles,
+                instructions,
+                llc_misses,
+                context_switches
+            };
+
+            //! file descriptors in the order of `Counts`, -1 if not available
+            std::array<int, n_events> fds{-1, -1, -1, -1};
+
+            //! position of each event in the group read, -1 if not available
+            std::array<int, n_events> slots{-1, -1, -1, -1};
+
+            int leader = -1;
+            unsigned n_open = 0;
+
+            EventGroup()
+            {
+#if REDGRAPES_PERF_COUNTERS
+                std::array<std::pair<uint32_t, uint64_t>, n_events> const events{
+                    {{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+                     {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+                     {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+                     {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES}}};
+
+                for(unsigned i = 0; i < n_events; ++i)
+                {
+                    perf_event_attr attr;
+                    std::memset(&attr, 0, sizeof(attr));
+                    attr.size = sizeof(attr);
+                    attr.type = events[i].first;
+                    attr.config = events[i].second;
+                    attr.read_format = PERF_FORMAT_GROUP;
+                    attr.disabled = leader < 0;
+                    // context switches happen in the kernel, only hardware events count user space alone
+                    attr.exclude_kernel = events[i].first == PERF_TYPE_HARDWARE;
+                    attr.exclude_hv = 1;
+
+                    int fd = (int) syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+                    if(fd < 0)
+                    {
+                        SPDLOG_DEBUG("perf_event_open failed for counter {}: {}", i, strerror(errno));
+                        continue;
+                    }
+
+                    if(leader < 0)
+                        leader = fd;
+                    fds[i] = fd;
+                    slots[i] = n_open++;
+                }
+
+                if(leader >= 0)
+                {
+                    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+                    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+                }
+#endif
+            }
+
+            EventGroup(EventGroup const&) = delete;
+            EventGroup& operator=(EventGroup const&) = delete;
+
+            ~EventGroup()
+            {
+#if REDGRAPES_PERF_COUNTERS
+                for(int fd : fds)
+                    if(fd >= 0)
+                        close(fd);
+#endif
+            }
+
+            //! true if at least one counter could be opened
+            bool available() const
+            {
+                return leader >= 0;
+            }
+
+            bool available(Event event) const
+            {
+                return fds[event] >= 0;
+            }
+
+            Counts read() const
+            {
+                Counts c;
+#if REDGRAPES_PERF_COUNTERS
+                if(leader < 0)
+                    return c;
+
+                // layout of PERF_FORMAT_GROUP: number of events, followed by their values
+                uint64_t buf[1 + n_events];
+                if(::read(leader, buf, sizeof(buf)) < (ssize_t) ((1 + n_open) * sizeof(uint64_t)))
+                    return c;
+
+                auto value = [&](unsigned i) -> uint64_t { return slots[i] >= 0 ? buf[1 + slots[i]] : 0; };
+                c.cycles = value(cycles);
+                c.instructions = value(instructions);
+                c.llc_misses = value(llc_misses);
+                c.context_switches = value(context_switches);
+#endif
+                return c;
+            }
+        };
+
+        //! counters and summaries of one thread
+        struct ThreadState
+        {
+            std::unique_ptr<EventGroup> group;
+
+            std::mutex mutex;
+            std::unordered_map<std::string, Summary> by_label;
+        };
+
+        struct Registry
+        {
+            static inline std::atomic<bool> enabled{false};
+
+            static inline std::mutex mutex;
+            static inline std::vector<std::shared_ptr<ThreadState>> threads;
+
+            static inline thread_local std::shared_ptr<ThreadState> local;
+
+            //! state of the calling thread, opens its counters on first use
+            static ThreadState& local_state()
+            {
+                if(!local)
+                {
+                    local = std::make_shared<ThreadState>();
+                    local->group = std::make_unique<EventGroup>();
+                    if(!local->group->available())
+                        SPDLOG_WARN("perf_counters: no performance counters available on this thread");
+
+                    std::lock_guard<std::mutex> lock(mutex);
+                    threads.push_back(local);
+                }
+                return *local;
+            }
+        };
+
+        inline void enable()
+        {
+            Registry::enabled.store(true, std::memory_order_release);
+        }
+
+        inline void disable()
+        {
+            Registry::enabled.store(false, std::memory_order_release);
+        }
+
+        inline bool is_enabled()
+        {
+#if REDGRAPES_PERF_COUNTERS
+            return Registry::enabled.load(std::memory_order_relaxed);
+#else
+            return false;
+#endif
+        }
+
+        //! counter values at the start of a task
+        struct Sample
+        {
+            bool active = false;
+            Counts begin;
+        };
+
+        //! @return counter values to pass to `end_task()`, inactive if disabled
+        inline Sample begin_task()
+        {
+            Sample s;
+            if(is_enabled())
+            {
+                s.active = true;
+                s.begin = Registry::local_state().group->read();
+            }
+            return s;
+        }
+
+        //! attribute the counters since `sample` to the task with `label`
+        inline void end_task(Sample const& sample, std::string const& label)
+        {
+            if(!sample.active)
+                return;
+
+            ThreadState& state = Registry::local_state();
+            Counts const delta = state.group->read() - sample.begin;
+
+            {
+                std::lock_guard<std::mutex> lock(state.mutex);
+                Summary& s = state.by_label[label];
+                s.tasks++;
+                s.counts += delta;
+            }
+
+            tracer::record(tracer::Kind::Cycles, delta.cycles);
+            tracer::record(tracer::Kind::Instructions, delta.instructions);
+            tracer::record(tracer::Kind::CacheMisses, delta.llc_misses);
+            tracer::record(tracer::Kind::ContextSwitches, delta.context_switches);
+        }
+
+        //! label under which the counters of `task` are summarized
+        template<typename TTask>
+        std::string label_of(TTask const& task)
+        {
+            if constexpr(requires { task.label; })
+                return task.label;
+            else
+                return std::string();
+        }
+
+        /*! merge the summaries of all threads
+         *
+         * @return one summary per task label,
+         *         tasks without a `LabelProperty` are summarized under the empty label
+         */
+        inline std::map<std::string, Summary> summaries()
+        {
+            std::map<std::string, Summary> merged;
+
+            std::lock_guard<std::mutex> lock(Registry::mutex);
+            for(auto& thread : Registry::threads)
+            {
+                std::lock_guard<std::mutex> thread_lock(thread->mutex);
+                for(auto const& [label, summary] : thread->by_label)
+                    merged[label] += summary;
+            }
+            return merged;
+        }
+
+        //! drop all summaries collected so far
+        inline void reset()
+        {
+            std::lock_guard<std::mutex> lock(Registry::mutex);
+            for(auto& thread : Registry::threads)
+            {
+                std::lock_guard<std::mutex> thread_lock(thread->mutex);
+                thread->by_label.clear();
+            }
+        }
+
+    } // namespace perf_counters
+} // namespace redGrapes
+
+template<>
+struct fmt::formatter<redGrapes::perf_counters::Summary>
+{
+    constexpr auto parse(format_parse_context& ctx)
+    {
+        return ctx.begin();
+    }
+
+    template<typename FormatContext>
+    auto format(redGrapes::perf_counters::Summary const& s, FormatContext& ctx) const
+    {
+        return fmt::format_to(
+            ctx.out(),
+            "{{ \"tasks\" : {}, \"cycles\" : {}, \"instructions\" : {}, \"llc_misses\" : {}, "
+            "\"context_switches\" : {}, \"ipc\" : {:.3f} }}",
+            s.tasks,
+            s.counts.cycles,
+            s.counts.instructions,
+            s.counts.llc_misses,
+            s.counts.context_switches,
+            s.ipc());
+    }
+};
@@ -0,0 +1,100 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <hwloc.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace redGrapes
+{
+
+    /* policy to map worker threads onto the processing units (PUs) of the machine
+     */
+    enum class Placement
+    {
+        //! fill one core, cache and package after the other, in logical PU order
+        COMPACT,
+
+        /*! spread consecutive workers as far apart as possible,
+         *  i.e. alternate between packages first, then between the cores of a package
+         *  and only then between the hardware threads of a core
+         */
+        SCATTER
+    };
+
+    inline std::optional<Placement> parse_placement(std::string_view name)
+    {
+        if(name == "compact")
+            return Placement::COMPACT;
+        if(name == "scatter")
+            return Placement::SCATTER;
+        return std::nullopt;
+    }
+
+    inline char const* placement_name(Placement placement)
+    {
+        return placement == Placement::SCATTER ? "scatter" : "compact";
+    }
+
+    //! placement given by the environment variable `REDGRAPES_PLACEMENT`, compact by default
+    inline Placement placement_from_env()
+    {
+        if(char const* name = std::getenv("REDGRAPES_PLACEMENT"))
+            if(auto placement = parse_placement(name))
+                return *placement;
+        return Placement::COMPACT;
+    }
+
+    namespace placement
+    {
+        //! append the PUs below `obj`, interleaving the subtrees of its children
+        inline void scatter(hwloc_obj_t obj, std::vector<hwloc_obj_t>& order)
+        {
+            if(obj->type == HWLOC_OBJ_PU)
+            {
+                order.push_back(obj);
+                return;
+            }
+
+            std::vector<std::vector<hwloc_obj_t>> subtrees;
+            size_t max_len = 0;
+            for(unsigned i = 0; i < obj->arity; ++i)
+            {
+                subtrees.emplace_back();
+                scatter(obj->children[i], subtrees.back());
+                max_len = std::max(max_len, subtrees.back().size());
+            }
+
+            for(size_t k = 0; k < max_len; ++k)
+                for(auto const& subtree : subtrees)
+                    if(k < subtree.size())
+                        order.push_back(subtree[k]);
+        }
+
+        /* order in which workers are assigned to PUs
+         *
+         * @return all PUs of the topology, worker `i` runs on entry `i % size()`
+         */
+        inline std::vector<hwloc_obj_t> pu_order(hwloc_topology_t topology, Placement placement)
+        {
+            std::vector<hwloc_obj_t> order;
+            if(placement == Placement::SCATTER)
+                scatter(hwloc_get_root_obj(topology), order);
+            else
+                for(unsigned i = 0; i < unsigned(hwloc_get_nbobjs_by_type(topology, HWLOC_OBJ_PU)); ++i)
+                    order.push_back(hwloc_get_obj_by_type(topology, HWLOC_OBJ_PU, i));
+            return order;
+        }
+    } // namespace placement
+
+} // namespace redGrapes
@@ -0,0 +1,365 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/* if enabled, the built-in tracer is compiled in.
+ * It still has to be switched on at runtime with `tracer::enable()`
+ * or by setting the environment variable `REDGRAPES_TRACE` to an output file.
+ */
+#ifndef REDGRAPES_TRACER
+#    define REDGRAPES_TRACER 1
+#endif
+
+//! number of records kept per thread, must be a power of two
+#ifndef REDGRAPES_TRACER_BUFFER_SIZE
+#    define REDGRAPES_TRACER_BUFFER_SIZE (1 << 16)
+#endif
+
+namespace redGrapes
+{
+    /* Dependency-free tracer which records compact binary events
+     * into a ring buffer per thread. Recording only takes a timestamp
+     * and a few relaxed stores into the buffer of the calling thread, so it can stay
+     * enabled in production runs. When a buffer is full,
+     * the oldest records are overwritten.
+     *
+     * The collected records can be written as Chrome trace JSON,
+     * which can be opened with chrome://tracing or ui.perfetto.dev.
+     */
+    namespace tracer
+    {
+
+        enum class Kind : uint8_t
+        {
+            TaskStart,
+            TaskEnd,
+            Steal,
+            Sleep,
+            Wake,
+            Allocate,
+
+            //! hardware counters of the task which ends next, see `perf_counters`
+            Cycles,
+            Instructions,
+            CacheMisses,
+            ContextSwitches
+        };
+
+        struct Record
+        {
+            //! nanoseconds since the tracer epoch
+            uint64_t timestamp;
+
+            //! task id for task events, number of bytes for allocations, counter value for counters
+            uint64_t arg;
+
+            Kind kind;
+        };
+
+        /* ring buffer of one thread, written only by its owner.
+         *
+         * Other threads may copy the records while the owner writes,
+         * so every slot is guarded by a sequence number, which is odd
+         * while the slot is written and encodes the index of the record it holds.
+         */
+        struct ThreadBuffer
+        {
+            struct Slot
+            {
+                std::atomic<uint64_t> seq{0};
+                std::atomic<uint64_t> timestamp{0};
+                std::atomic<uint64_t> arg{0};
+                std::atomic<Kind> kind{Kind::TaskStart};
+            };
+
+            std::string name;
+            uint32_t tid;
+
+            size_t const mask;
+            std::unique_ptr<Slot[]> slots;
+
+            //! total number of records written so far
+            std::atomic<uint64_t> head{0};
+
+            //! records before this index were dropped by `clear()`, only written under `Tracer::mutex`
+            std::atomic<uint64_t> base{0};
+
+            ThreadBuffer(uint32_t tid, size_t capacity)
+                : name(fmt::format("thread {}", tid))
+                , tid(tid)
+                , mask(capacity - 1)
+                , slots(new Slot[capacity])
+            {
+            }
+
+            inline void push(Kind kind, uint64_t timestamp, uint64_t arg)
+            {
+                uint64_t h = head.load(std::memory_order_relaxed);
+                Slot& slot = slots[h & mask];
+
+                slot.seq.store(2 * h + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+                slot.timestamp.store(timestamp, std::memory_order_relaxed);
+                slot.arg.store(arg, std::memory_order_relaxed);
+                slot.kind.store(kind, std::memory_order_relaxed);
+                slot.seq.store(2 * h + 2, std::memory_order_release);
+
+                head.store(h + 1, std::memory_order_release);
+            }
+
+            /* copy all records which are still in the buffer.
+             * Records which are overwritten while copying are dropped.
+             */
+            std::vector<Record> snapshot() const
+            {
+                uint64_t end = head.load(std::memory_order_acquire);
+                uint64_t begin = std::max(end > mask ? end - mask - 1 : 0, base.load(std::memory_order_relaxed));
+
+                std::vector<Record> copy;
+                copy.reserve(end - std::min(begin, end));
+                for(uint64_t i = begin; i < end; ++i)
+                {
+                    Slot const& slot = slots[i & mask];
+                    uint64_t const seq = slot.seq.load(std::memory_order_acquire);
+                    if(seq != 2 * i + 2)
+                        continue;
+
+                    Record r{
+                        slot.timestamp.load(std::memory_order_relaxed),
+                        slot.arg.load(std::memory_order_relaxed),
+                        slot.kind.load(std::memory_order_relaxed)};
+
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if(slot.seq.load(std::memory_order_relaxed) == seq)
+                        copy.push_back(r);
+                }
+
+                return copy;
+            }
+        };
+
+        struct Tracer
+        {
+            static inline std::atomic<bool> enabled{false};
+            static inline size_t buffer_size = REDGRAPES_TRACER_BUFFER_SIZE;
+            static inline std::chrono::steady_clock::time_point const epoch = std::chrono::steady_clock::now();
+
+            static inline std::mutex mutex;
+            static inline std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+
+            static inline thread_local std::shared_ptr<ThreadBuffer> thread_buffer;
+            static inline thread_local std::string thread_name;
+
+            //! buffer of the calling thread, registered on first use
+            static ThreadBuffer& local_buffer()
+            {
+                if(!thread_buffer)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    thread_buffer = std::make_shared<ThreadBuffer>(buffers.size(), buffer_size);
+                    if(!thread_name.empty())
+                        thread_buffer->name = thread_name;
+                    buffers.push_back(thread_buffer);
+                }
+                return *thread_buffer;
+            }
+
+            static uint64_t now()
+            {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch)
+                    .count();
+            }
+        };
+
+        /* start recording.
+         * @param buffer_size number of records per thread,
+         *        applies to threads which did not record anything yet
+         */
+        inline void enable(size_t buffer_size = REDGRAPES_TRACER_BUFFER_SIZE)
+        {
+            assert((buffer_size & (buffer_size - 1)) == 0);
+            {
+                std::lock_guard<std::mutex> lock(Tracer::mutex);
+                Tracer::buffer_size = buffer_size;
+            }
+            Tracer::enabled.store(true, std::memory_order_release);
+        }
+
+        inline void disable()
+        {
+            Tracer::enabled.store(false, std::memory_order_release);
+        }
+
+        inline bool is_enabled()
+        {
+            return Tracer::enabled.load(std::memory_order_relaxed);
+        }
+
+        inline void record(Kind kind, uint64_t arg = 0)
+        {
+#if REDGRAPES_TRACER
+            if(Tracer::enabled.load(std::memory_order_relaxed))
+                Tracer::local_buffer().push(kind, Tracer::now(), arg);
+#endif
+        }
+
+        /* name of the calling thread in the exported trace.
+         * Does not allocate a buffer if the thread did not record anything yet.
+         */
+        inline void set_thread_name(std::string name)
+        {
+#if REDGRAPES_TRACER
+            Tracer::thread_name = name;
+            if(Tracer::thread_buffer)
+            {
+                std::lock_guard<std::mutex> lock(Tracer::mutex);
+                Tracer::thread_buffer->name = std::move(name);
+            }
+#endif
+        }
+
+        //! drop all records collected so far
+        inline void clear()
+        {
+            std::lock_guard<std::mutex> lock(Tracer::mutex);
+            // the head is only written by the owner of the buffer
+            for(auto& buffer : Tracer::buffers)
+                buffer->base.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+        }
+
+        /* write all collected records in the Chrome trace event format.
+         * Tasks and sleeping phases become slices on the track of
+         * their thread, all other records are instant events.
+         */
+        inline void write_chrome_json(std::ostream& out)
+        {
+            std::lock_guard<std::mutex> lock(Tracer::mutex);
+
+            out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+            bool first = true;
+            auto emit = [&](std::string const& event)
+            {
+                if(!first)
+                    out << ",";
+                out << "\n" << event;
+                first = false;
+            };
+
+            for(auto& buffer : Tracer::buffers)
+            {
+                emit(fmt::format(
+                    R"({{"name":"thread_name","ph":"M","pid":0,"tid":{},"args":{{"name":"{}"}}}})",
+                    buffer->tid,
+                    buffer->name));
+
+                // slices whose begin was already overwritten are skipped
+                unsigned open_tasks = 0;
+                unsigned open_sleeps = 0;
+
+                // counter values which are attached to the end of the next task slice
+                std::string counters;
+                auto add_counter = [&counters](char const* name, uint64_t value)
+                { counters += fmt::format(R"({}"{}":{})", counters.empty() ? "" : ",", name, value); };
+
+                for(Record const& r : buffer->snapshot())
+                {
+                    // fields common to all events of this record
+                    std::string const common
+                        = fmt::format(R"("pid":0,"tid":{},"ts":{:.3f})", buffer->tid, r.timestamp / 1000.0);
+
+                    switch(r.kind)
+                    {
+                    case Kind::TaskStart:
+                        ++open_tasks;
+                        emit(fmt::format(
+                            R"({{"name":"task {}","cat":"Task","ph":"B",{},"args":{{"id":{}}}}})",
+                            r.arg,
+                            common,
+                            r.arg));
+                        break;
+                    case Kind::TaskEnd:
+                        if(open_tasks > 0)
+                        {
+                            --open_tasks;
+                            if(counters.empty())
+                                emit(fmt::format(R"({{"ph":"E",{}}})", common));
+                            else
+                                emit(fmt::format(R"({{"ph":"E",{},"args":{{{}}}}})", common, counters));
+                        }
+                        counters.clear();
+                        break;
+                    case Kind::Sleep:
+                        ++open_sleeps;
+                        emit(fmt::format(R"({{"name":"sleep","cat":"Worker","ph":"B",{}}})", common));
+                        break;
+                    case Kind::Wake:
+                        if(open_sleeps > 0)
+                        {
+                            --open_sleeps;
+                            emit(fmt::format(R"({{"ph":"E",{}}})", common));
+                        }
+                        break;
+                    case Kind::Steal:
+                        emit(fmt::format(
+                            R"({{"name":"steal","cat":"Worker","ph":"i","s":"t",{},"args":{{"task":{}}}}})",
+                            common,
+                            r.arg));
+                        break;
+                    case Kind::Allocate:
+                        emit(fmt::format(
+                            R"({{"name":"allocate","cat":"Allocator","ph":"i","s":"t",{},"args":{{"bytes":{}}}}})",
+                            common,
+                            r.arg));
+                        break;
+                    case Kind::Cycles:
+                        add_counter("cycles", r.arg);
+                        break;
+                    case Kind::Instructions:
+                        add_counter("instructions", r.arg);
+                        break;
+                    case Kind::CacheMisses:
+                        add_counter("llc_misses", r.arg);
+                        break;
+                    case Kind::ContextSwitches:
+                        add_counter("context_switches", r.arg);
+                        break;
+                    }
+                }
+            }
+
+            out << "\n]}\n";
+        }
+
+        //! @return false if the file could not be written
+        inline bool write_chrome_json(std::string const& path)
+        {
+            std::ofstream out(path);
+            if(!out)
+                return false;
+
+            write_chrome_json(out);
+            return (bool) out;
+        }
+
+    } // namespace tracer
+} // namespace redGrapes
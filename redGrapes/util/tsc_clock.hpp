@@ -0,0 +1,94 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#    include <x86intrin.h>
+#endif
+
+namespace redGrapes
+{
+
+    /* Cheap monotonic clock based on the CPU timestamp counter.
+     *
+     * Reading it is a single instruction on x86 and aarch64,
+     * which makes it suitable for stamping every task.
+     * Ticks are converted to nanoseconds with a rate which is
+     * calibrated once against `std::chrono::steady_clock`.
+     * On other architectures, the steady clock is used directly.
+     */
+    struct TscClock
+    {
+        static inline uint64_t now()
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#elif defined(__aarch64__)
+            uint64_t ticks;
+            asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+            return ticks;
+#else
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+#endif
+        }
+
+        //! convert a difference of two `now()` values to nanoseconds
+        static inline uint64_t to_ns(uint64_t ticks)
+        {
+            return (uint64_t) (ticks * ns_per_tick());
+        }
+
+        static double ns_per_tick()
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            static double const rate = calibrate();
+            return rate;
+#elif defined(__aarch64__)
+            static double const rate = []
+            {
+                uint64_t freq;
+                asm volatile("mrs %0, cntfrq_el0" : "=r"(freq));
+                return 1.0e9 / freq;
+            }();
+            return rate;
+#else
+            return 1.0;
+#endif
+        }
+
+    private:
+        //! reference point for calibration, taken at program start
+        static inline std::chrono::steady_clock::time_point const reference_time = std::chrono::steady_clock::now();
+        static inline uint64_t const reference_ticks = now();
+
+        /* measure the tick rate since program start,
+         * waiting until at least one millisecond has passed
+         */
+        static double calibrate()
+        {
+            auto const min_duration = std::chrono::milliseconds(1);
+
+            std::chrono::steady_clock::time_point time;
+            uint64_t ticks;
+            do
+            {
+                time = std::chrono::steady_clock::now();
+                ticks = now();
+            } while(time - reference_time < min_duration);
+
+            double const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(time - reference_time).count();
+            return ns / (ticks - reference_ticks);
+        }
+    };
+
+} // namespace redGrapes
@@ -30,6 +30,17 @@ TEST_CASE("IOAccess")
     REQUIRE(IOAccess::is_serial(IOAccess{IOAccess::amul}, IOAccess{IOAccess::aadd}) == true);
     REQUIRE(IOAccess::is_serial(IOAccess{IOAccess::amul}, IOAccess{IOAccess::amul}) == false);
 
+    REQUIRE(IOAccess::is_serial(IOAccess{IOAccess::reduce}, IOAccess{IOAccess::reduce}) == false);
+    REQUIRE(IOAccess::is_serial(IOAccess{IOAccess::reduce}, IOAccess{IOAccess::read}) == true);
+    REQUIRE(IOAccess::is_serial(IOAccess{IOAccess::reduce}, IOAccess{IOAccess::write}) == true);
+    REQUIRE(IOAccess::is_serial(IOAccess{IOAccess::reduce}, IOAccess{IOAccess::aadd}) == true);
+
+    REQUIRE(IOAccess::is_serial(IOAccess{IOAccess::commute}, IOAccess{IOAccess::commute}) == false);
+    REQUIRE(IOAccess::is_serial(IOAccess{IOAccess::commute}, IOAccess{IOAccess::read}) == true);
+    REQUIRE(IOAccess::is_serial(IOAccess{IOAccess::commute}, IOAccess{IOAccess::write}) == true);
+    REQUIRE(IOAccess{IOAccess::write}.is_superset_of(IOAccess{IOAccess::commute}) == true);
+    REQUIRE(IOAccess{IOAccess::commute}.is_superset_of(IOAccess{IOAccess::write}) == false);
+
     // subsets
     REQUIRE(IOAccess{IOAccess::read}.is_superset_of(IOAccess{IOAccess::read}) == true);
     REQUIRE(IOAccess{IOAccess::read}.is_superset_of(IOAccess{IOAccess::write}) == false);
@@ -211,4 +222,16 @@ TEST_CASE("FieldAccess")
                 IOAccess{IOAccess::read},
                 Arr({AreaAccess({0, 10}), AreaAccess({0, 10}), AreaAccess({0, 10})})))
         == true);
+
+    // commutative accesses are not ordered, so the resource has to be locked as a whole
+    FieldAccess<3> const commute(
+        IOAccess{IOAccess::commute},
+        Arr({AreaAccess({0, 10}), AreaAccess({0, 10}), AreaAccess({0, 10})}));
+    REQUIRE(FieldAccess<3>::is_serial(commute, commute) == false);
+    REQUIRE(commute.is_commutative() == true);
+    REQUIRE(
+        FieldAccess<3>(IOAccess{IOAccess::write}, Arr({AreaAccess({0, 10}), AreaAccess({0, 10}), AreaAccess({0, 10})}))
+            .is_commutative()
+        == false);
+    REQUIRE(ArrayAccess<IOAccess, 2, Or_t>({IOAccess{IOAccess::read}, IOAccess{IOAccess::commute}}).is_commutative());
 }
@@ -0,0 +1,394 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <redGrapes/memory/allocator.hpp>
+#include <redGrapes/memory/chunk_cache.hpp>
+#include <redGrapes/memory/chunked_bump_alloc.hpp>
+#include <redGrapes/memory/recycle_pool.hpp>
+#include <redGrapes/memory/size_class.hpp>
+#include <redGrapes/redGrapes.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+//! counts the chunks which are currently allocated
+struct CountingAlloc
+{
+    unsigned* n_chunks;
+
+    //! optionally counts all calls to allocate()
+    unsigned* n_calls = nullptr;
+
+    redGrapes::memory::Block allocate(std::size_t n_bytes) noexcept
+    {
+        ++*n_chunks;
+        if(n_calls)
+            ++*n_calls;
+        return redGrapes::memory::Block{(uintptr_t) std::malloc(n_bytes), n_bytes};
+    }
+
+    void deallocate(redGrapes::memory::Block blk) noexcept
+    {
+        --*n_chunks;
+        std::free((void*) blk.ptr);
+    }
+};
+
+TEST_CASE("SizeClasses")
+{
+    using namespace redGrapes::memory;
+
+    for(std::size_t n = 1; n <= size_class::max_size; ++n)
+    {
+        std::size_t idx = size_class::index(n);
+        REQUIRE(size_class::size(idx) >= n);
+        REQUIRE(size_class::size(idx) % 16 == 0);
+
+        // no more than 25% waste above the small classes
+        if(n > size_class::small_limit)
+            REQUIRE(size_class::size(idx) * 4 <= n * 5);
+
+        if(idx > 0)
+            REQUIRE(size_class::size(idx - 1) < n);
+    }
+}
+
+TEST_CASE("ChunkedBumpAllocReuse")
+{
+    using namespace redGrapes::memory;
+
+    unsigned n_chunks = 0;
+    {
+        ChunkedBumpAlloc<CountingAlloc> alloc(CountingAlloc{&n_chunks}, 16 * 1024);
+
+        Block pinned = alloc.allocate(200);
+        REQUIRE(pinned.len == 224);
+
+        /* repeatedly allocate and free a batch of blocks
+         * while one allocation stays alive.
+         * the freed blocks must be reused instead of growing
+         * the number of chunks.
+         */
+        std::vector<Block> blocks;
+        for(int round = 0; round < 100; ++round)
+        {
+            for(int i = 0; i < 40; ++i)
+                blocks.push_back(alloc.allocate(100 + i));
+
+            for(Block blk : blocks)
+                alloc.deallocate(blk);
+            blocks.clear();
+        }
+
+        REQUIRE(n_chunks == 1);
+
+        // freed blocks are handed out again for the same size class
+        Block a = alloc.allocate(300);
+        alloc.deallocate(a);
+        Block b = alloc.allocate(290);
+        REQUIRE(a.ptr == b.ptr);
+        alloc.deallocate(b);
+
+        alloc.deallocate(pinned);
+    }
+}
+
+TEST_CASE("ChunkedBumpAllocManyChunks")
+{
+    using namespace redGrapes::memory;
+
+    unsigned n_chunks = 0;
+    {
+        ChunkedBumpAlloc<CountingAlloc> alloc(CountingAlloc{&n_chunks}, 16 * 1024);
+
+        // blocks above the largest size class, so each one occupies its own chunk
+        std::vector<Block> blocks;
+        for(int i = 0; i < 64; ++i)
+            blocks.push_back(alloc.allocate(6000));
+
+        REQUIRE(n_chunks >= 64);
+
+        std::shuffle(blocks.begin(), blocks.end(), std::mt19937(42));
+        for(Block blk : blocks)
+            alloc.deallocate(blk);
+
+        // appending new chunks unlinks and frees the erased ones
+        blocks.clear();
+        for(int i = 0; i < 2; ++i)
+            blocks.push_back(alloc.allocate(6000));
+
+        REQUIRE(n_chunks <= 3);
+
+        for(Block blk : blocks)
+            alloc.deallocate(blk);
+    }
+    REQUIRE(n_chunks == 0);
+}
+
+TEST_CASE("ChunkedBumpAllocLarge")
+{
+    using namespace redGrapes::memory;
+
+    unsigned n_chunks = 0;
+    {
+        ChunkedBumpAlloc<CountingAlloc> alloc(CountingAlloc{&n_chunks}, 16 * 1024);
+
+        Block small = alloc.allocate(64);
+        unsigned const n_small_chunks = n_chunks;
+
+        // requests above the chunk capacity get their own allocation of the exact size
+        Block large = alloc.allocate(100000);
+        REQUIRE(large);
+        REQUIRE(large.len == 100000);
+        REQUIRE(n_chunks == n_small_chunks + 1);
+        REQUIRE(alloc.stats().bytes_live == 64 + 100000);
+
+        std::fill((char*) large.ptr, (char*) large.ptr + large.len, 1);
+
+        alloc.deallocate(large);
+        REQUIRE(n_chunks == n_small_chunks);
+        REQUIRE(alloc.stats().bytes_live == 64);
+
+        alloc.deallocate(small);
+    }
+    REQUIRE(n_chunks == 0);
+}
+
+TEST_CASE("ChunkedBumpAllocRemoteFree")
+{
+    using namespace redGrapes::memory;
+
+    unsigned n_chunks = 0;
+    {
+        ChunkedBumpAlloc<CountingAlloc> alloc(CountingAlloc{&n_chunks}, 16 * 1024);
+
+        std::vector<Block> blocks;
+        std::set<uintptr_t> addrs;
+        for(int i = 0; i < 32; ++i)
+        {
+            blocks.push_back(alloc.allocate(256));
+            addrs.insert(blocks.back().ptr);
+        }
+
+        // free all blocks from a foreign thread
+        std::thread t(
+            [&]
+            {
+                for(Block blk : blocks)
+                    alloc.deallocate_remote(blk);
+            });
+        t.join();
+
+        // the next allocations reclaim the remotely freed blocks
+        blocks.clear();
+        for(int i = 0; i < 32; ++i)
+        {
+            blocks.push_back(alloc.allocate(256));
+            REQUIRE(addrs.count(blocks.back().ptr) == 1);
+        }
+
+        REQUIRE(n_chunks == 1);
+
+        for(Block blk : blocks)
+            alloc.deallocate(blk);
+    }
+    REQUIRE(n_chunks == 0);
+}
+
+TEST_CASE("ChunkedBumpAllocStats")
+{
+    using namespace redGrapes::memory;
+
+    unsigned n_chunks = 0;
+    ChunkedBumpAlloc<CountingAlloc> alloc(CountingAlloc{&n_chunks}, 16 * 1024);
+
+    Block a = alloc.allocate(100);
+    Block b = alloc.allocate(200);
+
+    AllocStats stats = alloc.stats();
+    REQUIRE(stats.bytes_live == 112 + 224);
+    REQUIRE(stats.bytes_rounding_waste == 12 + 24);
+    REQUIRE(stats.chunks_held == 1);
+    REQUIRE(stats.chunk_size == 16 * 1024);
+
+    alloc.deallocate(a);
+    alloc.deallocate_remote(b);
+
+    stats = alloc.stats();
+    REQUIRE(stats.bytes_live == 224);
+    REQUIRE(stats.bytes_cached == 112);
+    REQUIRE(stats.bytes_high_water == 112 + 224);
+    REQUIRE(stats.remote_frees == 1);
+
+    // a chunk which is exhausted, but kept alive by one block
+    ChunkedBumpAlloc<CountingAlloc> alloc2(CountingAlloc{&n_chunks}, 16 * 1024);
+    Block pin = alloc2.allocate(8000);
+    Block next = alloc2.allocate(8000);
+
+    stats = alloc2.stats();
+    REQUIRE(stats.chunks_held == 2);
+    REQUIRE(stats.chunks_pinned == 1);
+
+    alloc2.deallocate(pin);
+    alloc2.deallocate(next);
+}
+
+TEST_CASE("ChunkCache")
+{
+    using namespace redGrapes::memory;
+
+    unsigned n_chunks = 0;
+    unsigned n_calls = 0;
+    {
+        ChunkedBumpAlloc<ChunkCache<CountingAlloc>> alloc(
+            ChunkCache<CountingAlloc>(CountingAlloc{&n_chunks, &n_calls}, 4),
+            16 * 1024);
+
+        std::vector<Block> blocks;
+        for(int i = 0; i < 32; ++i)
+            blocks.push_back(alloc.allocate(6000));
+        for(Block blk : blocks)
+            alloc.deallocate(blk);
+
+        // drained chunks beyond the retention limit are given back
+        blocks.clear();
+        blocks.push_back(alloc.allocate(6000));
+        REQUIRE(n_chunks <= 2 + 4);
+        REQUIRE(alloc.stats().chunks_cached > 0);
+
+        // bursts of new chunks are served from the cache
+        unsigned const n_calls_before = n_calls;
+        for(int round = 0; round < 10; ++round)
+        {
+            for(int i = 0; i < 3; ++i)
+                blocks.push_back(alloc.allocate(6000));
+            for(int i = 0; i < 3; ++i)
+            {
+                alloc.deallocate(blocks.back());
+                blocks.pop_back();
+            }
+        }
+        REQUIRE(n_calls == n_calls_before);
+
+        alloc.deallocate(blocks.back());
+    }
+    REQUIRE(n_chunks == 0);
+}
+
+TEST_CASE("ChunkCacheRegions")
+{
+    using namespace redGrapes::memory;
+
+    size_t const chunk_size = 16 * 1024;
+    size_t const region_size = 2 * 1024 * 1024;
+
+    unsigned n_chunks = 0;
+    {
+        ChunkedBumpAlloc<ChunkCache<CountingAlloc>> alloc(
+            ChunkCache<CountingAlloc>(CountingAlloc{&n_chunks}, 4, region_size),
+            chunk_size);
+
+        // all chunks are carved out of a single region
+        std::vector<Block> blocks;
+        for(int i = 0; i < 64; ++i)
+            blocks.push_back(alloc.allocate(6000));
+        REQUIRE(n_chunks == 1);
+
+        for(Block blk : blocks)
+            alloc.deallocate(blk);
+        blocks.clear();
+
+        // freed chunks are reused instead of growing the region
+        for(int i = 0; i < 64; ++i)
+            blocks.push_back(alloc.allocate(6000));
+        REQUIRE(n_chunks == 1);
+
+        for(Block blk : blocks)
+            alloc.deallocate(blk);
+    }
+    REQUIRE(n_chunks == 0);
+}
+
+TEST_CASE("RecyclePool")
+{
+    using namespace redGrapes::memory;
+
+    RecyclePool pool;
+    REQUIRE(!pool.allocate(256));
+
+    std::vector<Block> blocks;
+    for(int i = 0; i < 4; ++i)
+        blocks.push_back(Block{(uintptr_t) std::malloc(256), 256});
+
+    for(Block blk : blocks)
+        REQUIRE(pool.deallocate(blk));
+    REQUIRE(pool.bytes_cached() == 4 * 256);
+
+    // blocks are keyed by their exact length and reused in LIFO order
+    REQUIRE(!pool.allocate(240));
+    Block blk = pool.allocate(256);
+    REQUIRE(blk == blocks.back());
+    REQUIRE(pool.deallocate(blk));
+
+    // only a limited number of sizes is recycled
+    for(size_t len = 16; len <= 16 * REDGRAPES_RECYCLE_POOL_BUCKETS; len += 16)
+        if(len != 256)
+            pool.deallocate(Block{(uintptr_t) std::malloc(len), len});
+
+    Block other{(uintptr_t) std::malloc(8 * 1024), 8 * 1024};
+    REQUIRE(!pool.deallocate(other));
+    std::free((void*) other.ptr);
+
+    unsigned n_drained = 0;
+    pool.drain(
+        [&](Block blk)
+        {
+            ++n_drained;
+            std::free((void*) blk.ptr);
+        });
+    REQUIRE(n_drained == 4 + REDGRAPES_RECYCLE_POOL_BUCKETS - 1);
+    REQUIRE(pool.bytes_cached() == 0);
+}
+
+TEST_CASE("RecyclingAllocatorRemoteFree")
+{
+    using namespace redGrapes::memory;
+
+    auto rg = redGrapes::init(1);
+    RecyclePool& pool = redGrapes::TaskFreeCtx::worker_alloc_pool.get_recycle_pool(0);
+    auto& arena = redGrapes::TaskFreeCtx::worker_alloc_pool.get_alloc(0);
+
+    // task storage allocated by worker 0 and freed by the main thread
+    Block blk = rg.emplace_task([] { return RecyclingAllocator(0).allocate(256); }).get();
+    rg.barrier();
+    size_t cached = pool.bytes_cached();
+    size_t remote_frees = arena.stats().remote_frees;
+
+    RecyclingAllocator(0).deallocate(blk);
+    REQUIRE(pool.bytes_cached() == cached);
+    REQUIRE(arena.stats().remote_frees == remote_frees + 1);
+
+    // the owner recycles its own blocks
+    size_t recycled = rg.emplace_task(
+                            [&pool]
+                            {
+                                RecyclingAllocator alloc(0);
+                                Block blk = alloc.allocate(256);
+                                size_t cached = pool.bytes_cached();
+                                alloc.deallocate(blk);
+                                return pool.bytes_cached() - cached;
+                            })
+                          .get();
+    REQUIRE(recycled == 256);
+    REQUIRE(arena.stats().remote_frees == remote_frees + 1);
+}
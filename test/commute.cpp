@@ -0,0 +1,153 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <redGrapes/redGrapes.hpp>
+#include <redGrapes/resource/ioresource.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    //! block until `flag` is set, but at most a few seconds so a failing test does not hang
+    bool wait_for_flag(std::atomic<bool> const& flag)
+    {
+        auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while(!flag.load())
+        {
+            if(std::chrono::steady_clock::now() > deadline)
+                return false;
+            std::this_thread::yield();
+        }
+        return true;
+    }
+} // namespace
+
+TEST_CASE("commutative access is exclusive")
+{
+    auto rg = redGrapes::init(4);
+    {
+        redGrapes::IOResource<int> counter(0);
+        std::atomic<int> inside{0};
+        std::atomic<int> overlaps{0};
+
+        for(int i = 0; i < 200; ++i)
+            rg.emplace_task(
+                [&](auto counter)
+                {
+                    if(inside.fetch_add(1) != 0)
+                        overlaps++;
+                    std::this_thread::yield();
+                    ++*counter;
+                    inside.fetch_sub(1);
+                },
+                counter.commute());
+
+        // a following write is ordered after all of them
+        int seen = 0;
+        rg.emplace_task([&seen](auto counter) { seen = *counter; }, counter.write());
+
+        rg.barrier();
+        REQUIRE(overlaps == 0);
+        REQUIRE(seen == 200);
+    }
+}
+
+TEST_CASE("commutative access is unordered")
+{
+    auto rg = redGrapes::init(2);
+    {
+        redGrapes::IOResource<std::vector<int>> sink;
+        redGrapes::IOResource<int> input(0);
+        std::atomic<bool> go{false}, released{false};
+
+        // the first append also depends on a task which only finishes after the second append
+        rg.emplace_task([&](auto) { released = wait_for_flag(go); }, input.write());
+        rg.emplace_task([](auto sink, auto) { sink->push_back(1); }, sink.commute(), input.read());
+        rg.emplace_task(
+            [&](auto sink)
+            {
+                sink->push_back(2);
+                go = true;
+            },
+            sink.commute());
+
+        rg.barrier();
+        REQUIRE(released);
+        REQUIRE(*sink == std::vector<int>{2, 1});
+    }
+}
+
+TEST_CASE("commutative access of child tasks")
+{
+    auto rg = redGrapes::init(2);
+    {
+        redGrapes::IOResource<int> counter(0);
+        for(int i = 0; i < 4; ++i)
+            rg.emplace_task(
+                [&rg](auto counter)
+                {
+                    ++*counter;
+                    for(int j = 0; j < 4; ++j)
+                        rg.emplace_task([](auto counter) { ++*counter; }, counter.commute());
+                },
+                counter.commute());
+
+        rg.barrier();
+        REQUIRE(*counter == 20);
+    }
+}
+
+TEST_CASE("commutative access to several resources")
+{
+    auto rg = redGrapes::init(4);
+    {
+        redGrapes::IOResource<int> a(0), b(0);
+        std::atomic<int> inside_a{0}, inside_b{0};
+        std::atomic<int> overlaps{0};
+
+        auto enter = [&](std::atomic<int>& inside)
+        {
+            if(inside.fetch_add(1) != 0)
+                overlaps++;
+        };
+        auto both = [&](auto a, auto b)
+        {
+            enter(inside_a);
+            enter(inside_b);
+            std::this_thread::yield();
+            ++*a;
+            ++*b;
+            inside_a.fetch_sub(1);
+            inside_b.fetch_sub(1);
+        };
+
+        // the resources are listed in opposite orders, but always taken in the same one
+        for(int i = 0; i < 100; ++i)
+        {
+            rg.emplace_task([both](auto a, auto b) { both(a, b); }, a.commute(), b.commute());
+            rg.emplace_task([both](auto b, auto a) { both(a, b); }, b.commute(), a.commute());
+            rg.emplace_task(
+                [&](auto a)
+                {
+                    enter(inside_a);
+                    ++*a;
+                    inside_a.fetch_sub(1);
+                },
+                a.commute());
+        }
+
+        rg.barrier();
+        REQUIRE(overlaps == 0);
+        REQUIRE(*a == 300);
+        REQUIRE(*b == 200);
+    }
+}
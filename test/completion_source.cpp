@@ -0,0 +1,153 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <redGrapes/dispatch/polling_worker.hpp>
+#include <redGrapes/redGrapes.hpp>
+#include <redGrapes/resource/ioresource.hpp>
+#include <redGrapes/scheduler/thread_scheduler.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/* completion source whose operations finish
+ * after they were polled a given number of times
+ */
+template<typename TTask>
+struct CountdownSource
+{
+    std::mutex mutex;
+    std::vector<std::pair<unsigned, redGrapes::scheduler::EventPtr<TTask>>> pending;
+    redGrapes::CondVar& worker_cv;
+
+    CountdownSource(redGrapes::CondVar& worker_cv) : worker_cv(worker_cv)
+    {
+    }
+
+    void add(unsigned n_polls, redGrapes::scheduler::EventPtr<TTask> event)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending.emplace_back(n_polls, event);
+        }
+        worker_cv.notify();
+    }
+
+    bool empty()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return pending.empty();
+    }
+
+    unsigned poll()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        unsigned n_finished = 0;
+        for(auto it = pending.begin(); it != pending.end();)
+            if(--it->first == 0)
+            {
+                it->second.notify();
+                it = pending.erase(it);
+                ++n_finished;
+            }
+            else
+                ++it;
+        return n_finished;
+    }
+};
+
+template<typename TTask>
+struct CountdownWorker : redGrapes::dispatch::PollingWorker<TTask, CountdownWorker<TTask>>
+{
+    std::shared_ptr<CountdownSource<TTask>> source;
+
+    CountdownWorker(redGrapes::WorkerId worker_id)
+        : redGrapes::dispatch::PollingWorker<TTask, CountdownWorker<TTask>>(worker_id)
+        , source(std::make_shared<CountdownSource<TTask>>(this->cv))
+    {
+        this->add_completion_source(source);
+    }
+};
+
+struct CountdownTag
+{
+};
+
+static_assert(redGrapes::dispatch::C_CompletionSource<CountdownSource<redGrapes::Task<>>>);
+
+TEST_CASE("CompletionSourceSet")
+{
+    struct Source
+    {
+        unsigned pending;
+
+        unsigned poll()
+        {
+            unsigned n = pending;
+            pending = 0;
+            return n;
+        }
+
+        bool empty()
+        {
+            return pending == 0;
+        }
+    };
+
+    redGrapes::dispatch::CompletionSourceSet set;
+    REQUIRE(set.empty());
+    REQUIRE(set.poll() == 0);
+
+    auto a = std::make_shared<Source>(Source{2});
+    auto b = std::make_shared<Source>(Source{0});
+    set.add(a);
+    set.add(b);
+    REQUIRE(!set.empty());
+
+    b->pending = 3;
+    REQUIRE(set.poll() == 5);
+    REQUIRE(set.empty());
+}
+
+TEST_CASE("CustomCompletionSource")
+{
+    using RGTask = redGrapes::Task<>;
+
+    auto rg = redGrapes::init(
+        redGrapes::SchedulerDescription(
+            std::make_shared<redGrapes::scheduler::ThreadScheduler<CountdownWorker<RGTask>>>(),
+            CountdownTag{}),
+        redGrapes::SchedulerDescription(
+            std::make_shared<redGrapes::scheduler::PoolScheduler<redGrapes::dispatch::thread::DefaultWorker<RGTask>>>(
+                1),
+            redGrapes::DefaultTag{}));
+
+    auto source = rg.getScheduler<CountdownTag>().m_worker_thread->worker.source;
+
+    redGrapes::IOResource<std::vector<int>> log;
+
+    for(int i = 0; i < 8; ++i)
+        rg.emplace_task<CountdownTag>(
+              [&rg, source, i](auto log)
+              {
+                  // wait for an operation that completes after a few polls
+                  auto event = *rg.create_event();
+                  source->add(i + 1, event);
+                  rg.yield(event);
+
+                  log->push_back(i);
+              },
+              log.write())
+            .enable_stack_switching();
+
+    auto result = rg.emplace_task([](auto log) { return *log; }, log.read()).get();
+
+    REQUIRE(result == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7});
+    REQUIRE(source->empty());
+}
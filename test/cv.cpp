@@ -1,9 +1,11 @@
 
+#include <redGrapes/sync/backoff.hpp>
 #include <redGrapes/sync/cv.hpp>
 
 #include <catch2/catch_test_macros.hpp>
 
 #include <atomic>
+#include <chrono>
 #include <thread>
 
 TEST_CASE("CV")
@@ -35,3 +37,77 @@ TEST_CASE("CV")
         t.join();
     }
 }
+
+TEST_CASE("CV default timeout")
+{
+    unsigned const saved = redGrapes::CondVar::default_timeout;
+
+    redGrapes::CondVar::default_timeout = 7;
+    REQUIRE(redGrapes::CondVar().timeout == 7);
+    REQUIRE(redGrapes::CondVar(3).timeout == 3);
+
+    redGrapes::CondVar::default_timeout = saved;
+}
+
+TEST_CASE("CV wait_for")
+{
+    using namespace std::chrono_literals;
+
+    redGrapes::CondVar cv;
+
+    // nobody notifies
+    auto begin = std::chrono::steady_clock::now();
+    REQUIRE(!cv.wait_for(20ms));
+    REQUIRE(std::chrono::steady_clock::now() - begin >= 20ms);
+
+    // a notify before the call is not lost
+    cv.notify();
+    REQUIRE(cv.wait_for(10s));
+
+    // a notify interrupts the sleep long before the timeout
+    std::thread t(
+        [&]
+        {
+            std::this_thread::sleep_for(10ms);
+            cv.notify();
+        });
+    begin = std::chrono::steady_clock::now();
+    REQUIRE(cv.wait_for(10s));
+    REQUIRE(std::chrono::steady_clock::now() - begin < 5s);
+    t.join();
+
+    // the notification was consumed
+    REQUIRE(!cv.wait_for(1ms));
+}
+
+TEST_CASE("PollBackoff")
+{
+    using namespace std::chrono_literals;
+
+    redGrapes::CondVar cv;
+    redGrapes::PollBackoff backoff(3, 8us);
+
+    // spinning does not sleep
+    for(int i = 0; i < 3; ++i)
+    {
+        REQUIRE(!backoff.pause(cv));
+        REQUIRE(backoff.current_delay() == 1us);
+    }
+
+    // then the sleep doubles up to the maximum
+    for(auto expected : {2us, 4us, 8us, 8us, 8us})
+    {
+        REQUIRE(!backoff.pause(cv));
+        REQUIRE(backoff.current_delay() == expected);
+    }
+
+    // a notification interrupts the sleep
+    cv.notify();
+    REQUIRE(backoff.pause(cv));
+
+    // progress starts over with spinning
+    backoff.reset();
+    REQUIRE(backoff.current_delay() == 1us);
+    cv.notify();
+    REQUIRE(!backoff.pause(cv));
+}
@@ -0,0 +1,51 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <redGrapes/redGrapes.hpp>
+#include <redGrapes/resource/reductionresource.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+
+TEST_CASE("ReductionResource")
+{
+    auto rg = redGrapes::init(4);
+    {
+        redGrapes::ReductionResource<int> sum;
+        for(int i = 1; i <= 1000; ++i)
+            rg.emplace_task([i](auto acc) { *acc += i; }, sum.reduce());
+
+        int seen = 0;
+        rg.emplace_task([&seen](auto sum) { seen = *sum; }, sum.read());
+
+        // the writer sees the merged value and later reductions add to it
+        rg.emplace_task([](auto sum) { *sum *= 2; }, sum.write());
+        for(int i = 0; i < 10; ++i)
+            rg.emplace_task([](auto acc) { *acc += 1; }, sum.reduce());
+
+        rg.barrier();
+        REQUIRE(seen == 500500);
+        REQUIRE(*sum == 2 * 500500 + 10);
+    }
+    {
+        using Histogram = std::vector<unsigned>;
+        auto combine = [](Histogram a, Histogram const& b)
+        {
+            for(size_t i = 0; i < a.size(); ++i)
+                a[i] += b[i];
+            return a;
+        };
+
+        redGrapes::ReductionResource<Histogram, decltype(combine)> hist(Histogram(8, 0), combine);
+        for(unsigned i = 0; i < 800; ++i)
+            rg.emplace_task([i](auto h) { (*h)[i % 8]++; }, hist.reduce());
+
+        rg.wait(hist.read());
+        REQUIRE(*hist == Histogram(8, 100));
+    }
+}
@@ -7,11 +7,15 @@
 
 #include <redGrapes/redGrapes.hpp>
 #include <redGrapes/resource/ioresource.hpp>
+#include <redGrapes/util/placement.hpp>
 
 #include <catch2/catch_test_macros.hpp>
 #include <spdlog/spdlog.h>
 
+#include <array>
 #include <chrono>
+#include <numeric>
+#include <thread>
 
 
 using namespace std::chrono;
@@ -52,3 +56,127 @@ TEST_CASE("WorkerUtilization")
 
     test_worker_utilization(std::thread::hardware_concurrency());
 }
+
+/*
+ * tasks whose closure does not fit into
+ * a single allocator chunk
+ */
+TEST_CASE("LargeTask")
+{
+    auto rg = redGrapes::init(1);
+
+    std::array<int, 64 * 1024> values;
+    std::iota(values.begin(), values.end(), 0);
+
+    int64_t expected = std::accumulate(values.begin(), values.end(), int64_t(0));
+
+    for(int i = 0; i < 16; ++i)
+    {
+        auto sum = rg.emplace_task([values] { return std::accumulate(values.begin(), values.end(), int64_t(0)); });
+        REQUIRE(sum.get() == expected);
+    }
+}
+
+TEST_CASE("SchedulerStats")
+{
+    auto rg = redGrapes::init(2);
+
+    for(int i = 0; i < 32; ++i)
+        rg.emplace_task([] {});
+    rg.barrier();
+
+    std::vector<redGrapes::scheduler::SchedulerStats> stats = rg.scheduler_stats();
+    REQUIRE(stats.size() == 2);
+
+    redGrapes::scheduler::SchedulerStats total;
+    for(auto const& s : stats)
+        total += s;
+
+    REQUIRE(total.tasks_executed == 32);
+    REQUIRE(total.tasks_initialized == 32);
+    REQUIRE(total.emplacement_pops + total.steal_new_successes == 32);
+    REQUIRE(total.steal_ready_successes <= total.steal_ready_attempts);
+    REQUIRE(total.steal_new_successes <= total.steal_new_attempts);
+    REQUIRE(total.wakeups_received > 0);
+    REQUIRE(total.free_worker_misses <= total.free_worker_searches);
+    REQUIRE(total.claim_conflicts <= total.bitfield_probes);
+
+    // counters start over with the next phase
+    rg.reset_scheduler_stats();
+    for(auto const& s : rg.scheduler_stats())
+        REQUIRE(s.tasks_executed == 0);
+
+    auto f = rg.emplace_task([] { return 1; });
+    REQUIRE(f.get() == 1);
+
+    total = {};
+    for(auto const& s : rg.scheduler_stats())
+        total += s;
+    REQUIRE(total.tasks_executed == 1);
+}
+
+#if REDGRAPES_SCHEDULER_STATS
+TEST_CASE("SchedulerStatsResetWhileRunning")
+{
+    redGrapes::scheduler::WorkerCounters counters;
+    redGrapes::CondVar::WaitStats const spin{1};
+    size_t const n = 1000000;
+
+    // the owning thread keeps counting while another thread resets
+    std::atomic<bool> started{false};
+    std::thread owner(
+        [&]
+        {
+            redGrapes::scheduler::WorkerCounters::current = &counters;
+            for(size_t i = 0; i < n; ++i)
+            {
+                counters.on_wait(spin);
+                if(i == n / 2)
+                    started = true;
+            }
+        });
+
+    while(!started)
+        std::this_thread::yield();
+    counters.reset();
+    owner.join();
+
+    // a reset is never undone by a concurrent increment
+    redGrapes::scheduler::SchedulerStats stats;
+    counters.read(stats);
+    REQUIRE(stats.spin_iterations < n - n / 2);
+
+    counters.reset();
+    counters.read(stats);
+    REQUIRE(stats.spin_iterations == 0);
+    counters.on_wait(spin);
+    counters.read(stats);
+    REQUIRE(stats.spin_iterations == 1);
+}
+#endif
+
+TEST_CASE("Placement")
+{
+    hwloc_topology_t topology;
+    hwloc_topology_init(&topology);
+    hwloc_topology_set_synthetic(topology, "pack:2 core:2 pu:2");
+    hwloc_topology_load(topology);
+
+    auto logical_indices = [&](redGrapes::Placement placement)
+    {
+        std::vector<unsigned> idx;
+        for(hwloc_obj_t pu : redGrapes::placement::pu_order(topology, placement))
+            idx.push_back(pu->logical_index);
+        return idx;
+    };
+
+    REQUIRE(logical_indices(redGrapes::Placement::COMPACT) == std::vector<unsigned>{0, 1, 2, 3, 4, 5, 6, 7});
+
+    // alternate packages first, then cores, then hardware threads
+    REQUIRE(logical_indices(redGrapes::Placement::SCATTER) == std::vector<unsigned>{0, 4, 2, 6, 1, 5, 3, 7});
+
+    hwloc_topology_destroy(topology);
+
+    REQUIRE(redGrapes::parse_placement("scatter") == redGrapes::Placement::SCATTER);
+    REQUIRE(!redGrapes::parse_placement("spread"));
+}
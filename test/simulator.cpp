@@ -0,0 +1,239 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "../benchmarks/sim/simulator.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::vector<std::string> const placements{"runtime", "round_robin", "first_free", "locality"};
+    std::vector<std::string> const steals{"none", "next_busy", "random", "most_loaded"};
+    std::vector<std::string> const priorities{"fifo", "lifo", "critical_path"};
+
+    //! task released at 0 with the given resource accesses
+    sim::TaskGraph::Task task(uint64_t duration_ns, std::vector<sim::TaskGraph::Access> accesses)
+    {
+        sim::TaskGraph::Task t;
+        t.duration_ns = duration_ns;
+        t.accesses = std::move(accesses);
+        return t;
+    }
+
+    sim::TaskGraph make_graph(std::vector<sim::TaskGraph::Task> tasks)
+    {
+        sim::TaskGraph graph;
+        for(size_t i = 0; i < tasks.size(); ++i)
+        {
+            tasks[i].id = i;
+            graph.tasks.push_back(tasks[i]);
+        }
+        graph.derive_dependencies();
+        return graph;
+    }
+
+    sim::Result simulate(
+        sim::TaskGraph const& graph,
+        sim::Config const& config,
+        std::string const& placement_name,
+        std::string const& steal_name,
+        std::string const& priority_name)
+    {
+        auto placement = sim::policy::make_placement(placement_name);
+        auto steal = sim::policy::make_steal(steal_name);
+        auto priority = sim::policy::make_priority(priority_name);
+        REQUIRE(placement);
+        REQUIRE(steal);
+        REQUIRE(priority);
+        return sim::Simulator(graph, config, *placement, *steal, *priority).run();
+    }
+
+    //! calls f(workers, result) for every combination of policies and the given worker counts
+    template<typename F>
+    void for_all_policies(sim::TaskGraph const& graph, std::vector<unsigned> const& workers, F&& f)
+    {
+        for(unsigned n : workers)
+            for(auto const& placement : placements)
+                for(auto const& steal : steals)
+                    for(auto const& priority : priorities)
+                    {
+                        sim::Config config;
+                        config.workers = n;
+                        f(n, simulate(graph, config, placement, steal, priority));
+                    }
+    }
+} // namespace
+
+TEST_CASE("SimulatorChain")
+{
+    // every task writes the same resource
+    sim::TaskGraph const graph = make_graph({task(10, {{0, true}}), task(20, {{0, true}}), task(30, {{0, true}})});
+    REQUIRE(graph.critical_path_ns() == 60);
+
+    for_all_policies(
+        graph,
+        {1, 2, 4},
+        [](unsigned n, sim::Result const& r)
+        {
+            REQUIRE(r.makespan_ns == 60);
+            REQUIRE(r.work_ns == 60);
+            REQUIRE(r.lower_bound_ns == 60);
+            REQUIRE(r.utilization(n) == 1.0 / n);
+            REQUIRE(r.efficiency() == 1.0);
+            REQUIRE(r.tasks[1].start == 10);
+            REQUIRE(r.tasks[2].start == 30);
+            for(sim::TaskResult const& t : r.tasks)
+                REQUIRE(t.slack == 0);
+        });
+}
+
+TEST_CASE("SimulatorForkJoin")
+{
+    /*      a (10)
+     *     /      \
+     *  b (20)   c (30)
+     *     \      /
+     *      d (5)
+     */
+    sim::TaskGraph const graph = make_graph(
+        {task(10, {{0, true}, {1, true}}),
+         task(20, {{0, true}}),
+         task(30, {{1, true}}),
+         task(5, {{0, false}, {1, false}})});
+    REQUIRE(graph.critical_path_ns() == 45);
+    REQUIRE(graph.total_work_ns() == 65);
+
+    // only b is off the critical path
+    for_all_policies(
+        graph,
+        {1},
+        [](unsigned, sim::Result const& r)
+        {
+            REQUIRE(r.makespan_ns == 65);
+            REQUIRE(r.utilization(1) == 1.0);
+            REQUIRE(r.tasks[0].slack == 0);
+            REQUIRE(r.tasks[1].slack == 10);
+            REQUIRE(r.tasks[2].slack == 0);
+            REQUIRE(r.tasks[3].slack == 0);
+        });
+
+    // b and c run in parallel if the placement puts them onto different workers
+    for(auto const& placement : {"runtime", "round_robin", "first_free"})
+        for(auto const& steal : steals)
+        {
+            sim::Result const r = simulate(graph, sim::Config{2}, placement, steal, "fifo");
+            REQUIRE(r.makespan_ns == 45);
+            REQUIRE(r.lower_bound_ns == 45);
+            REQUIRE(r.utilization(2) == 65.0 / 90.0);
+            REQUIRE(r.tasks[1].worker != r.tasks[2].worker);
+        }
+
+    // locality queues both behind the waker, the idle worker sleeps unless it is notified and steals
+    for(auto const& steal : steals)
+        REQUIRE(simulate(graph, sim::Config{2}, "locality", steal, "fifo").makespan_ns == 65);
+
+    sim::Config notify{2};
+    notify.notify_idle = true;
+    REQUIRE(simulate(graph, notify, "locality", "none", "fifo").makespan_ns == 65);
+
+    sim::Result const stolen = simulate(graph, notify, "locality", "next_busy", "fifo");
+    REQUIRE(stolen.makespan_ns == 45);
+    REQUIRE(stolen.steals == 1);
+    REQUIRE(stolen.tasks[2].stolen);
+
+    // a stolen task starts later
+    notify.steal_ns = 4;
+    REQUIRE(simulate(graph, notify, "locality", "next_busy", "fifo").makespan_ns == 49);
+}
+
+TEST_CASE("SimulatorResourceConflict")
+{
+    // two writers of one resource are serialized, two readers are not
+    sim::TaskGraph const writers = make_graph({task(10, {{0, true}}), task(10, {{0, true}})});
+    sim::TaskGraph const readers = make_graph({task(10, {{0, false}}), task(10, {{0, false}})});
+    REQUIRE(writers.preds[1] == std::vector<size_t>{0});
+    REQUIRE(readers.preds[1].empty());
+
+    for_all_policies(
+        writers,
+        {1, 2},
+        [](unsigned n, sim::Result const& r)
+        {
+            REQUIRE(r.makespan_ns == 20);
+            REQUIRE(r.utilization(n) == 1.0 / n);
+            REQUIRE(r.tasks[1].start == 10);
+            REQUIRE(r.tasks[0].slack == 0);
+            REQUIRE(r.tasks[1].slack == 0);
+        });
+
+    for_all_policies(
+        readers,
+        {1},
+        [](unsigned, sim::Result const& r) { REQUIRE(r.makespan_ns == 20); });
+
+    // released at the same time, round-robin puts them onto different workers
+    for(auto const& placement : {"runtime", "round_robin"})
+        for(auto const& steal : steals)
+            for(auto const& priority : priorities)
+            {
+                sim::Result const r = simulate(readers, sim::Config{2}, placement, steal, priority);
+                REQUIRE(r.makespan_ns == 10);
+                REQUIRE(r.utilization(2) == 1.0);
+                REQUIRE(r.tasks[0].slack == 0);
+                REQUIRE(r.tasks[1].slack == 0);
+            }
+
+    // the overhead is added to every task
+    sim::Config overhead{1};
+    overhead.overhead_ns = 3;
+    REQUIRE(simulate(writers, overhead, "runtime", "none", "fifo").makespan_ns == 26);
+}
+
+TEST_CASE("SimulatorDeterministic")
+{
+    // random accesses to a few resources, with child tasks
+    std::mt19937 gen(7);
+    std::vector<sim::TaskGraph::Task> tasks;
+    for(size_t i = 0; i < 300; ++i)
+    {
+        sim::TaskGraph::Task t = task(std::uniform_int_distribution<uint64_t>(1, 1000)(gen), {});
+        t.release_ns = std::uniform_int_distribution<uint64_t>(0, 5000)(gen);
+        for(unsigned r = 0; r < 6; ++r)
+            if(std::uniform_int_distribution<int>(0, 3)(gen) == 0)
+                t.accesses.push_back({r, std::uniform_int_distribution<int>(0, 1)(gen) == 1});
+        if(i > 0 && std::uniform_int_distribution<int>(0, 9)(gen) == 0)
+            t.parent = i - 1;
+        tasks.push_back(t);
+    }
+    sim::TaskGraph const graph = make_graph(tasks);
+
+    sim::Config config{4};
+    config.notify_idle = true;
+    config.steal_ns = 50;
+    for(auto const& placement : placements)
+        for(auto const& steal : steals)
+            for(auto const& priority : priorities)
+            {
+                sim::Result const a = simulate(graph, config, placement, steal, priority);
+                sim::Result const b = simulate(graph, config, placement, steal, priority);
+
+                REQUIRE(a.makespan_ns >= a.lower_bound_ns);
+                REQUIRE(a.makespan_ns == b.makespan_ns);
+                REQUIRE(a.steals == b.steals);
+                for(size_t i = 0; i < graph.size(); ++i)
+                {
+                    REQUIRE(a.tasks[i].start == b.tasks[i].start);
+                    REQUIRE(a.tasks[i].end == b.tasks[i].end);
+                    REQUIRE(a.tasks[i].worker == b.tasks[i].worker);
+                    REQUIRE(a.tasks[i].stolen == b.tasks[i].stolen);
+                }
+            }
+}
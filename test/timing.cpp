@@ -0,0 +1,68 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <redGrapes/redGrapes.hpp>
+#include <redGrapes/task/property/label.hpp>
+#include <redGrapes/task/property/timing.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <thread>
+
+TEST_CASE("TimingHistogram")
+{
+    redGrapes::timing::Histogram h;
+    for(uint64_t ns = 1; ns <= 1000; ++ns)
+        h.record(ns);
+
+    REQUIRE(h.count == 1000);
+    REQUIRE(h.max_ns == 1000);
+    REQUIRE(h.mean_ns() == 500);
+
+    // quantiles are exact up to the bucket width
+    REQUIRE(h.quantile_ns(0.5) >= 500);
+    REQUIRE(h.quantile_ns(0.5) < 1000);
+    REQUIRE(h.quantile_ns(0.99) == 1000);
+    REQUIRE(h.quantile_ns(0.0) == 1);
+}
+
+TEST_CASE("TimingProperty")
+{
+    using namespace std::chrono;
+
+    redGrapes::timing::reset();
+    {
+        auto rg = redGrapes::init<redGrapes::LabelProperty, redGrapes::TimingProperty>(1);
+        auto r = rg.createIOResource<int>(0);
+
+        for(int i = 0; i < 8; ++i)
+            rg.emplace_task([](auto) { std::this_thread::sleep_for(milliseconds(2)); }, r.write())
+                .label("sleep");
+
+        auto f = rg.emplace_task([] { return 1; });
+        REQUIRE(f.get() == 1);
+        rg.barrier();
+    }
+
+    auto summaries = redGrapes::timing::summaries();
+    REQUIRE(summaries.count("sleep") == 1);
+    REQUIRE(summaries.count("") == 1);
+
+    redGrapes::timing::Summary const& s = summaries["sleep"];
+    REQUIRE(s.run.count == 8);
+    REQUIRE(s.run.quantile_ns(0.0) >= 1'000'000);
+
+    // each writer waits for its predecessors, so the last one queued for at least 7 runs
+    REQUIRE(s.queue_wait.count == 8);
+    REQUIRE(s.queue_wait.max_ns >= 7 * 2'000'000);
+
+    REQUIRE(summaries[""].run.count == 1);
+
+    redGrapes::timing::reset();
+    REQUIRE(redGrapes::timing::summaries().empty());
+}
@@ -0,0 +1,231 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <redGrapes/redGrapes.hpp>
+#include <redGrapes/resource/ioresource.hpp>
+#include <redGrapes/task/property/label.hpp>
+#include <redGrapes/util/graph_recorder.hpp>
+#include <redGrapes/util/perf_counters.hpp>
+#include <redGrapes/util/tracer.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static size_t count_occurrences(std::string const& str, std::string const& pattern)
+{
+    size_t count = 0;
+    for(size_t pos = str.find(pattern); pos != std::string::npos; pos = str.find(pattern, pos + 1))
+        ++count;
+    return count;
+}
+
+TEST_CASE("TracerRingBuffer")
+{
+    using namespace redGrapes::tracer;
+
+    enable(16);
+
+    std::vector<Record> records;
+    std::thread t(
+        [&records]
+        {
+            for(uint64_t i = 0; i < 100; ++i)
+                record(Kind::Allocate, i);
+
+            // only the latest records are kept
+            records = Tracer::thread_buffer->snapshot();
+        });
+    t.join();
+
+    disable();
+    clear();
+
+    REQUIRE(records.size() <= 16);
+    REQUIRE(records.size() >= 15);
+    REQUIRE(records.back().arg == 99);
+    for(size_t i = 1; i < records.size(); ++i)
+    {
+        REQUIRE(records[i].arg == records[i - 1].arg + 1);
+        REQUIRE(records[i].timestamp >= records[i - 1].timestamp);
+    }
+}
+
+TEST_CASE("TracerConcurrentSnapshot")
+{
+    using namespace redGrapes::tracer;
+
+    enable(64);
+
+    std::atomic<std::shared_ptr<ThreadBuffer>> buffer;
+    std::atomic<bool> stop{false};
+    std::thread t(
+        [&]
+        {
+            record(Kind::Allocate, 0);
+            buffer = Tracer::thread_buffer;
+            for(uint64_t i = 1; !stop; ++i)
+                record(Kind::Allocate, i);
+        });
+
+    while(!buffer.load())
+        std::this_thread::yield();
+
+    // records copied while the owner overwrites the ring are either complete or dropped
+    for(int n = 0; n < 1000; ++n)
+    {
+        std::vector<Record> records = buffer.load()->snapshot();
+        REQUIRE(records.size() <= 64);
+        for(size_t i = 1; i < records.size(); ++i)
+        {
+            REQUIRE(records[i].kind == Kind::Allocate);
+            REQUIRE(records[i].arg > records[i - 1].arg);
+            REQUIRE(records[i].timestamp >= records[i - 1].timestamp);
+        }
+    }
+
+    // records before a clear are not reported anymore
+    clear();
+    uint64_t const cleared = buffer.load()->base.load();
+    for(Record const& r : buffer.load()->snapshot())
+        REQUIRE(r.arg >= cleared);
+
+    stop = true;
+    t.join();
+    disable();
+    clear();
+}
+
+TEST_CASE("TracerChromeJson")
+{
+    redGrapes::tracer::enable();
+    {
+        auto rg = redGrapes::init(1);
+        for(int i = 0; i < 10; ++i)
+            rg.emplace_task([] {});
+        rg.barrier();
+    }
+    redGrapes::tracer::disable();
+
+    std::stringstream out;
+    redGrapes::tracer::write_chrome_json(out);
+    redGrapes::tracer::clear();
+
+    std::string json = out.str();
+    REQUIRE(json.find("\"traceEvents\"") != std::string::npos);
+    REQUIRE(json.find("\"name\":\"worker 0\"") != std::string::npos);
+    REQUIRE(count_occurrences(json, "\"cat\":\"Task\",\"ph\":\"B\"") == 10);
+
+    // all slices are closed
+    REQUIRE(count_occurrences(json, "\"ph\":\"B\"") == count_occurrences(json, "\"ph\":\"E\""));
+}
+
+TEST_CASE("GraphRecorder")
+{
+    redGrapes::graph_recorder::enable();
+    {
+        auto rg = redGrapes::init<redGrapes::LabelProperty>(1);
+        auto a = rg.createIOResource<int>(0);
+
+        // one writer followed by two independent readers
+        auto event = rg.emplace_task(
+                           [&rg](auto a)
+                           {
+                               *a = 1;
+                               return rg.create_event();
+                           },
+                           a.write())
+                         .label("write \"a\"")
+                         .get();
+        rg.emplace_task([](auto a) { REQUIRE(*a == 1); }, a.read()).label("read 1");
+        rg.emplace_task([](auto a) { REQUIRE(*a == 1); }, a.read()).label("read 2");
+
+        // keep the writer alive until both readers were inserted into the graph
+        while(redGrapes::graph_recorder::collect().edges.size() < 2)
+            std::this_thread::yield();
+
+        event->notify();
+        rg.barrier();
+    }
+    redGrapes::graph_recorder::disable();
+
+    redGrapes::graph_recorder::Graph graph = redGrapes::graph_recorder::collect();
+    REQUIRE(graph.tasks.size() == 3);
+    for(auto const& [id, task] : graph.tasks)
+    {
+        REQUIRE(task.span);
+        REQUIRE(task.span->begin >= task.node.submitted);
+        REQUIRE(task.span->end >= task.span->begin);
+    }
+
+    // both readers depend on the writer, but not on each other
+    REQUIRE(graph.edges.size() == 2);
+    auto const writer = graph.tasks.begin()->first;
+    for(auto const& edge : graph.edges)
+    {
+        REQUIRE(edge.from == writer);
+        REQUIRE(!edge.pre_event);
+        REQUIRE(!edge.reached);
+    }
+
+    std::stringstream json;
+    redGrapes::graph_recorder::write_json(json);
+    REQUIRE(json.str().find(R"("label":"write \"a\"")") != std::string::npos);
+    REQUIRE(json.str().find(R"("resources":[{ "resourceID")") != std::string::npos);
+
+    std::stringstream dot;
+    redGrapes::graph_recorder::write_dot(dot);
+    REQUIRE(dot.str().find("digraph") == 0);
+    REQUIRE(count_occurrences(dot.str(), fmt::format("t{} -> ", writer)) == 2);
+
+    redGrapes::graph_recorder::clear();
+}
+
+TEST_CASE("PerfCounters")
+{
+    redGrapes::perf_counters::enable();
+    redGrapes::tracer::enable();
+    {
+        auto rg = redGrapes::init<redGrapes::LabelProperty>(1);
+        for(int i = 0; i < 4; ++i)
+            rg.emplace_task(
+                  []
+                  {
+                      volatile uint64_t x = 0;
+                      for(int j = 0; j < 100000; ++j)
+                          x = x + j;
+                  })
+                .label("loop");
+        rg.barrier();
+    }
+    redGrapes::tracer::disable();
+    redGrapes::perf_counters::disable();
+
+    auto summaries = redGrapes::perf_counters::summaries();
+    REQUIRE(summaries["loop"].tasks == 4);
+
+    std::stringstream out;
+    redGrapes::tracer::write_chrome_json(out);
+    redGrapes::tracer::clear();
+
+    // counters are attached to the end of each task slice
+    REQUIRE(count_occurrences(out.str(), "\"args\":{\"cycles\":") == 4);
+
+    // the counters might not be accessible in restricted environments
+    using redGrapes::perf_counters::EventGroup;
+    EventGroup group;
+    if(group.available(EventGroup::instructions))
+        REQUIRE(summaries["loop"].counts.instructions >= 4 * 100000);
+    if(group.available(EventGroup::cycles))
+        REQUIRE(summaries["loop"].counts.cycles > 0);
+
+    redGrapes::perf_counters::reset();
+}
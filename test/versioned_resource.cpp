@@ -0,0 +1,108 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <redGrapes/redGrapes.hpp>
+#include <redGrapes/resource/versionedresource.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    //! block until `flag` is set, but at most a few seconds so a failing test does not hang
+    bool wait_for_flag(std::atomic<bool> const& flag)
+    {
+        auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while(!flag.load())
+        {
+            if(std::chrono::steady_clock::now() > deadline)
+                return false;
+            std::this_thread::yield();
+        }
+        return true;
+    }
+} // namespace
+
+TEST_CASE("VersionedResource")
+{
+    auto rg = redGrapes::init(3);
+    {
+        redGrapes::VersionedResource<std::vector<int>> buf(16, 1);
+
+        // the reader of the first version only finishes when released by the main thread
+        std::atomic<bool> release{false}, reader_done{false};
+        int old_sum = 0;
+        rg.emplace_task(
+            [&](auto buf)
+            {
+                if(wait_for_flag(release))
+                    for(int x : *buf)
+                        old_sum += x;
+                reader_done = true;
+            },
+            buf.read());
+
+        rg.emplace_task(
+            [](auto buf)
+            {
+                for(int& x : *buf)
+                    x = 2;
+            },
+            buf.overwrite());
+
+        // later accesses refer to the new version and are ordered after the overwrite
+        rg.emplace_task(
+            [](auto buf)
+            {
+                for(int& x : *buf)
+                    x += 1;
+            },
+            buf.write());
+        int new_sum = 0;
+        rg.emplace_task(
+            [&](auto buf)
+            {
+                for(int x : *buf)
+                    new_sum += x;
+            },
+            buf.read());
+
+        // all users of the new version finish while the reader of the old one is still running
+        rg.wait(buf.write());
+        REQUIRE_FALSE(reader_done);
+        REQUIRE(new_sum == 16 * 3);
+
+        release = true;
+        rg.barrier();
+        REQUIRE(old_sum == 16);
+        REQUIRE((*buf)[0] == 3);
+        REQUIRE(buf.buffers() == 2);
+    }
+    {
+        redGrapes::VersionedResource<int> value(0);
+        std::atomic<int> mismatches{0};
+        std::set<redGrapes::ResourceId> ids;
+        for(int i = 1; i <= 100; ++i)
+        {
+            rg.emplace_task([i](auto v) { *v = i; }, value.overwrite());
+            rg.emplace_task([&mismatches, i](auto v) { mismatches += (*v != i); }, value.read());
+            ids.insert(value.read().resource_id());
+            rg.barrier();
+        }
+
+        // the buffers of finished versions are reused together with their resource ids
+        REQUIRE(mismatches == 0);
+        REQUIRE(*value == 100);
+        REQUIRE(value.buffers() <= 2);
+        REQUIRE(ids.size() == value.buffers());
+    }
+}
@@ -0,0 +1,59 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <redGrapes/redGrapes.hpp>
+#include <redGrapes/resource/ioresource.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+    //! block until `flag` is set, but at most a few seconds so a failing test does not hang
+    bool wait_for_flag(std::atomic<bool> const& flag)
+    {
+        auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while(!flag.load())
+        {
+            if(std::chrono::steady_clock::now() > deadline)
+                return false;
+            std::this_thread::yield();
+        }
+        return true;
+    }
+} // namespace
+
+TEST_CASE("wait for resource access")
+{
+    // two workers are blocked by the unrelated tasks, one runs the rest
+    auto rg = redGrapes::init(3);
+    {
+        redGrapes::IOResource<int> a(0), b(0);
+        std::atomic<bool> release{false}, released{false};
+
+        // unrelated task which only finishes after the wait returned
+        rg.emplace_task([&](auto) { released = wait_for_flag(release); }, b.write());
+        rg.emplace_task([](auto a) { *a = 42; }, a.write());
+
+        rg.wait(a.read());
+        REQUIRE(*a == 42);
+        REQUIRE_FALSE(released);
+
+        // readers do not wait for other readers
+        rg.emplace_task([&](auto) { released = wait_for_flag(release); }, a.read());
+        rg.wait(a.read());
+        REQUIRE_FALSE(released);
+
+        release = true;
+        rg.wait(a, b);
+        REQUIRE(released);
+    }
+    rg.barrier();
+}